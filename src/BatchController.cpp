@@ -0,0 +1,58 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+#include "BatchController.h"
+
+#include <algorithm>
+
+namespace silisizer {
+
+static int clampSize(double size) {
+  return (int) std::clamp(size, 1.0, (double) MAX_BATCH_SWAPS);
+}
+
+int DoublingController::nextSize(int current, const BatchFeedback &feedback) {
+  double delta_wns_frac =
+      -(feedback.wns_after - feedback.wns_before) / feedback.wns_before;
+  if (delta_wns_frac < 0.1 && current < MAX_BATCH_SWAPS) return current * 2;
+  return current;
+}
+
+int PredictiveController::nextSize(int current,
+                                   const BatchFeedback &feedback) {
+  if (feedback.swaps == 0) return clampSize(2.0 * current);
+  if (feedback.wns_after < feedback.wns_before)
+    return clampSize(current / 2.0);
+
+  double tns_gain =
+      (feedback.tns_after - feedback.tns_before) / feedback.swaps;
+  if (!(tns_gain > 0.0) || feedback.tns_after >= 0.0)
+    return clampSize(2.0 * current);
+  double needed = -feedback.tns_after / tns_gain * ESTIMATE_FRACTION;
+  return clampSize(std::clamp(needed, current / 2.0,
+                              (double) current * MAX_GROWTH));
+}
+
+std::unique_ptr<BatchController> makeBatchController(BatchPolicy policy) {
+  switch (policy) {
+    case BatchPolicy::predictive:
+      return std::make_unique<PredictiveController>();
+    case BatchPolicy::doubling:
+      break;
+  }
+  return std::make_unique<DoublingController>();
+}
+
+}  // namespace silisizer
@@ -0,0 +1,74 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+namespace silisizer {
+
+// Largest batch any policy may ask for
+const int MAX_BATCH_SWAPS = 1048576;
+
+// Timing before and after the previous batch. Slacks are in seconds and
+// negative while violating; the first pass of a run has no batch behind it
+// (swaps == 0).
+struct BatchFeedback {
+  size_t swaps = 0;
+  double wns_before = 0.0;
+  double wns_after = 0.0;
+  double tns_before = 0.0;
+  double tns_after = 0.0;
+};
+
+enum class BatchPolicy {
+  doubling,    // double while WNS improves by less than 10% per batch
+  predictive,  // size from the observed TNS gain per swap
+};
+
+// Chooses how many offenders the next batch upsizes
+class BatchController {
+ public:
+  virtual ~BatchController() = default;
+  // Next batch size given the `current` one and how the last batch did
+  virtual int nextSize(int current, const BatchFeedback &feedback) = 0;
+};
+
+// Grow the batch 2x whenever the last one recovered less than 10% of WNS.
+// Never shrinks.
+class DoublingController : public BatchController {
+ public:
+  int nextSize(int current, const BatchFeedback &feedback) override;
+};
+
+// Estimate the swaps still needed as the remaining TNS over the TNS gained
+// per swap by the last batch, and ask for half of that so the estimate is
+// re-measured before it is spent. The batch may shrink to half or grow to 8x
+// per step; a batch that made WNS worse halves it, and a batch with no
+// measurable gain falls back to doubling.
+class PredictiveController : public BatchController {
+ public:
+  int nextSize(int current, const BatchFeedback &feedback) override;
+
+ private:
+  static constexpr double ESTIMATE_FRACTION = 0.5;
+  static constexpr int MAX_GROWTH = 8;
+};
+
+std::unique_ptr<BatchController> makeBatchController(BatchPolicy policy);
+
+}  // namespace silisizer
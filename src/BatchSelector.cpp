@@ -0,0 +1,76 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+#include "BatchSelector.h"
+
+namespace silisizer {
+
+void PathMembership::build(
+    const std::vector<const std::vector<EndpointPath> *> &scene_paths) {
+  paths_.clear();
+  path_count_ = 0;
+  for (const std::vector<EndpointPath> *paths : scene_paths) {
+    for (const EndpointPath &path : *paths) {
+      uint32_t id = (uint32_t) path_count_++;
+      for (const PathStep &step : path.steps) {
+        // Input and output pins of one instance are consecutive steps
+        std::vector<uint32_t> &ids = paths_[step.inst];
+        if (ids.empty() || ids.back() != id) ids.push_back(id);
+      }
+    }
+  }
+}
+
+std::vector<Offender> popDisjoint(OffenderQueue &queue, size_t count,
+                                  const PathMembership &membership,
+                                  const FoldIndex &folds) {
+  std::vector<Offender> picked;
+  std::vector<bool> covered(membership.pathCount(), false);
+  size_t uncovered = membership.pathCount();
+  while (picked.size() < count && uncovered > 0 && !queue.empty()) {
+    Offender offender = queue.popTop(1).front();
+    int fold = folds.find(offender.first);
+    if (fold < 0) continue;
+
+    // Every folded copy is swapped with the offender, so the group is on
+    // the paths of all its leaves, and it may share none of them with an
+    // earlier pick
+    std::vector<uint32_t> group_paths;
+    bool overlaps = false;
+    for (sta::Instance *leaf : folds.leaves(fold)) {
+      const std::vector<uint32_t> *paths = membership.paths(leaf);
+      if (!paths) continue;
+      for (uint32_t id : *paths) {
+        if (covered[id]) {
+          overlaps = true;
+          break;
+        }
+        group_paths.push_back(id);
+      }
+      if (overlaps) break;
+    }
+    if (overlaps || group_paths.empty()) continue;
+    // Copies can share a path, so count each once
+    for (uint32_t id : group_paths) {
+      if (covered[id]) continue;
+      covered[id] = true;
+      uncovered--;
+    }
+    picked.push_back(offender);
+  }
+  return picked;
+}
+
+}  // namespace silisizer
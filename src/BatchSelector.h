@@ -0,0 +1,58 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "EndpointCache.h"
+#include "FoldIndex.h"
+#include "OffenderQueue.h"
+
+namespace silisizer {
+
+// Violating endpoint paths through each resizable instance, numbered across
+// scenes in scene order, as collected by the backtrace of this pass
+class PathMembership {
+ public:
+  void build(const std::vector<const std::vector<EndpointPath> *> &scene_paths);
+
+  // Paths through `inst` in increasing order, or nullptr if it is on none
+  const std::vector<uint32_t> *paths(const sta::Instance *inst) const {
+    auto it = paths_.find(inst);
+    return it == paths_.end() ? nullptr : &it->second;
+  }
+  size_t pathCount() const { return path_count_; }
+
+ private:
+  std::unordered_map<const sta::Instance *, std::vector<uint32_t>> paths_;
+  size_t path_count_ = 0;
+};
+
+// Pop up to `count` offenders, best first, keeping only those whose fold
+// group shares no violating path with any earlier pick of the batch, so the
+// picks are strictly path-disjoint. Upsizing one cell of a path is usually
+// enough to move it, so the batch spreads over as many endpoints as it can.
+// Passed-over offenders are dropped from the queue and come back with the
+// next sync; popping stops once every path is taken.
+std::vector<Offender> popDisjoint(OffenderQueue &queue, size_t count,
+                                  const PathMembership &membership,
+                                  const FoldIndex &folds);
+
+}  // namespace silisizer
@@ -0,0 +1,78 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+#include "DelayGain.h"
+
+#include "sta/Liberty.hh"
+#include "sta/MinMax.hh"
+#include "sta/Scene.hh"
+#include "sta/TimingArc.hh"
+
+namespace silisizer {
+
+// Arc of `faster` with the same ports and edges as `arc`, or nullptr
+static const sta::TimingArc *matchingArc(const sta::LibertyCell *faster,
+                                         const sta::TimingArc *arc) {
+  sta::TimingArcSet *set = faster->findTimingArcSet(arc->set());
+  if (!set) return nullptr;
+  for (const sta::TimingArc *fast_arc : set->arcs())
+    if (fast_arc->fromEdge() == arc->fromEdge() &&
+        fast_arc->toEdge() == arc->toEdge())
+      return fast_arc;
+  return nullptr;
+}
+
+DelayGainTable::DelayGainTable(const SpeedLadder &ladder) {
+  for (const sta::LibertyCell *cell : ladder.cells()) {
+    const sta::LibertyCell *faster = ladder.faster(cell);
+    if (!faster) continue;
+    for (const sta::TimingArcSet *set : cell->timingArcSets()) {
+      for (const sta::TimingArc *arc : set->arcs()) {
+        const sta::TimingArc *fast_arc = matchingArc(faster, arc);
+        if (!fast_arc) continue;
+        index_.emplace(arc, (int) intrinsic_gain_.size());
+        intrinsic_gain_.push_back(arc->intrinsicDelay() -
+                                  fast_arc->intrinsicDelay());
+        drive_gain_.push_back(arc->driveResistance() -
+                              fast_arc->driveResistance());
+      }
+    }
+  }
+}
+
+float drivenLoad(const sta::Sta *sta, const sta::Pin *drvr_pin,
+                 const sta::RiseFall *rf, const sta::Scene *scene) {
+  float pin_cap, wire_cap;
+  sta->connectedCap(drvr_pin, rf, scene, sta::MinMax::max(), pin_cap,
+                    wire_cap);
+  return pin_cap + wire_cap;
+}
+
+void DrivenLoads::lookUp(const sta::Sta *sta, const KeySet &keys) {
+  for (const Key &key : keys) {
+    auto [it, inserted] = loads_.try_emplace(key, 0.0f);
+    if (inserted) it->second = drivenLoad(sta, key.pin, key.rf, key.scene);
+  }
+}
+
+float worstDrivenLoad(const sta::Sta *sta, const sta::Pin *drvr_pin) {
+  float load = 0.0f;
+  for (const sta::Scene *scene : sta->scenes())
+    for (const sta::RiseFall *rf : sta::RiseFall::range())
+      load = std::max(load, drivenLoad(sta, drvr_pin, rf, scene));
+  return load;
+}
+
+}  // namespace silisizer
@@ -0,0 +1,98 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "SpeedLadder.h"
+#include "sta/Sta.hh"
+
+namespace silisizer {
+
+// Per-arc delay reduction of moving a cell one grade up its speed ladder,
+// built once from the Liberty models of both grades. Each arc of a resizable
+// cell is matched to the arc of its faster cell with the same ports and
+// edges, and the gain is kept as the linear delay model
+//   gain(load) = (intrinsic0 - intrinsic1) + (R0 - R1) * load
+// in two flat arrays indexed through one pointer lookup.
+class DelayGainTable {
+ public:
+  explicit DelayGainTable(const SpeedLadder &ladder);
+
+  // Entry of `arc`, or -1 if its cell has no faster arc to compare with
+  int find(const sta::TimingArc *arc) const {
+    auto it = index_.find(arc);
+    return it == index_.end() ? -1 : it->second;
+  }
+  // Delay removed from entry `entry` when it drives `load_cap`; upsizing
+  // never counts as making an arc slower
+  float gain(int entry, float load_cap) const {
+    return std::max(0.0f,
+                    intrinsic_gain_[entry] + drive_gain_[entry] * load_cap);
+  }
+  size_t size() const { return intrinsic_gain_.size(); }
+
+ private:
+  std::unordered_map<const sta::TimingArc *, int> index_;
+  std::vector<float> intrinsic_gain_;
+  std::vector<float> drive_gain_;
+};
+
+// Pin and wire capacitance on the net of `drvr_pin` for `rf` in `scene`.
+// Not reentrant: connectedCap can reduce parasitics on first use, so callers
+// on several threads go through a DrivenLoads table instead.
+float drivenLoad(const sta::Sta *sta, const sta::Pin *drvr_pin,
+                 const sta::RiseFall *rf, const sta::Scene *scene);
+
+// Driven loads looked up on one thread and then read from any number. Keys
+// are gathered while the threads walk their paths, looked up once each, and
+// the threads then rate their steps from the table.
+class DrivenLoads {
+ public:
+  struct Key {
+    const sta::Pin *pin;
+    const sta::RiseFall *rf;
+    const sta::Scene *scene;
+    bool operator==(const Key &other) const {
+      return pin == other.pin && rf == other.rf && scene == other.scene;
+    }
+  };
+  struct KeyHash {
+    size_t operator()(const Key &key) const {
+      std::hash<const void *> hash;
+      return hash(key.pin) ^ (hash(key.rf) * 31) ^ (hash(key.scene) * 961);
+    }
+  };
+  typedef std::unordered_set<Key, KeyHash> KeySet;
+
+  // Look up the keys of `keys` not in the table yet; one thread at a time
+  void lookUp(const sta::Sta *sta, const KeySet &keys);
+  // Load of a looked up key; safe from several threads
+  float load(const Key &key) const { return loads_.at(key); }
+
+ private:
+  std::unordered_map<Key, float, KeyHash> loads_;
+};
+// Largest drivenLoad() over both edges and every scene
+float worstDrivenLoad(const sta::Sta *sta, const sta::Pin *drvr_pin);
+
+}  // namespace silisizer
@@ -0,0 +1,420 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+#include "EndpointCache.h"
+
+#include <algorithm>
+#include <memory>
+#include <unordered_set>
+#include <utility>
+
+#include "Parallel.h"
+#include "ResourceUsage.h"
+#include "sta/Graph.hh"
+#include "sta/Liberty.hh"
+#include "sta/Network.hh"
+#include "sta/PathEnd.hh"
+#include "sta/Search.hh"
+#include "sta/TimingRole.hh"
+#include "sta/VisitPathEnds.hh"
+
+namespace silisizer {
+
+// A path step whose gain depends on the load its pin drives
+struct PendingGain {
+  size_t step;
+  int entry;
+  DrivenLoads::Key load;
+};
+
+// Follow a violating path backwards and keep every resizable instance on it,
+// together with the delay that upsizing would remove from the arc that enters
+// it. Steps rated at the load they drive are left in `pending`, with their
+// loads in `loads`, for resolveGains(). Returns the number of path pins
+// visited.
+static size_t backtrace(const sta::Sta *sta, const SpeedLadder *ladder,
+                        const DelayGainTable *gains, sta::Path *path,
+                        std::vector<PathStep> &steps,
+                        std::vector<PendingGain> &pending,
+                        DrivenLoads::KeySet &loads) {
+  sta::Network *network = sta->network();
+  size_t visited = 0;
+  for (sta::Path* p = path; p && !p->isNull(); p = p->prevPath()) {
+    visited++;
+    // Get the pin
+    sta::Pin *pin = p->pin(sta);
+    // Get previous arc
+    sta::TimingArc* prev_arc = p->prevArc(sta);
+    // Past a transparent latch the path is in a different launch cycle
+    if (prev_arc && prev_arc->role()->isLatchDtoQ()) break;
+    // Get the instance and cell
+    sta::Instance* inst = network->instance(pin);
+    sta::Cell* cell = network->cell(inst);
+    // If the instance does not have a cell, skip
+    if (!cell) continue;
+    // If cell is not a Liberty cell, skip
+    sta::LibertyCell* libcell = network->libertyCell(cell);
+    if (!libcell) continue;
+    // If cell is already at its fastest speed, skip
+    if (!ladder->isResizable(libcell)) continue;
+    // Get the arc gain; arcs without a faster model keep their intrinsic
+    // delay, and wire arcs gain nothing
+    float gain = 0.0f;
+    if (prev_arc) {
+      int entry = gains->find(prev_arc);
+      if (entry < 0) {
+        gain = prev_arc->intrinsicDelay();
+      } else {
+        DrivenLoads::Key load{pin, p->transition(sta), p->scene(sta)};
+        pending.push_back({steps.size(), entry, load});
+        loads.insert(load);
+      }
+    }
+    steps.push_back({inst, gain});
+  }
+  return visited;
+}
+
+// Rate the pending steps of one backtrace at their looked up loads
+static void resolveGains(const DelayGainTable *gains,
+                         const DrivenLoads &loads,
+                         const std::vector<PendingGain> &pending,
+                         std::vector<PathStep> &steps) {
+  for (const PendingGain &step : pending)
+    steps[step.step].gain = gains->gain(step.entry, loads.load(step.load));
+}
+
+namespace {
+
+// Keeps a snapshot of the worst setup path end of one endpoint while the
+// search visits them. The visited path ends are temporaries of the search.
+class WorstPathVisitor : public sta::PathEndVisitor {
+ public:
+  WorstPathVisitor(const sta::Sta *sta, const SpeedLadder *ladder,
+                   const DelayGainTable *gains, const sta::SceneSeq *scenes)
+      : sta_(sta), ladder_(ladder), gains_(gains), scenes_(scenes) {}
+  sta::PathEndVisitor *copy() const override {
+    return new WorstPathVisitor(*this);
+  }
+  void visit(sta::PathEnd *path_end) override;
+
+  // Only paths with less slack than `bound` are backtraced
+  void reset(double bound) {
+    found = false;
+    slack = bound;
+    steps.clear();
+    clock = nullptr;
+  }
+
+  // True once a path under the bound was seen
+  bool found = false;
+  double slack = 0.0;
+  std::vector<PathStep> steps;
+  const sta::Clock *clock = nullptr;
+  size_t visited = 0;
+
+ private:
+  // Loads of every endpoint visited so far, all on the visiting thread
+  DrivenLoads loads_;
+  std::vector<PendingGain> pending_;
+  DrivenLoads::KeySet keys_;
+  const sta::Sta *sta_;
+  const SpeedLadder *ladder_;
+  const DelayGainTable *gains_;
+  // Scenes to keep, or nullptr for all of them
+  const sta::SceneSeq *scenes_;
+};
+
+void WorstPathVisitor::visit(sta::PathEnd *path_end) {
+  // Same checks as the findPathEnds query: setup only
+  if (path_end->isUnconstrained()) return;
+  const sta::TimingRole *role = path_end->checkRole(sta_);
+  if (role != sta::TimingRole::setup() &&
+      role != sta::TimingRole::outputSetup() &&
+      role != sta::TimingRole::latchSetup())
+    return;
+  if (scenes_ && std::find(scenes_->begin(), scenes_->end(),
+                           path_end->path()->scene(sta_)) == scenes_->end())
+    return;
+  double path_slack = path_end->slack(sta_);
+  if (path_slack >= slack) return;
+  found = true;
+  slack = path_slack;
+  clock = path_end->targetClk(sta_);
+  steps.clear();
+  pending_.clear();
+  keys_.clear();
+  visited += backtrace(sta_, ladder_, gains_, path_end->path(), steps,
+                       pending_, keys_);
+  loads_.lookUp(sta_, keys_);
+  resolveGains(gains_, loads_, pending_, steps);
+}
+
+}  // namespace
+
+EndpointCache::EndpointCache(sta::Sta *sta, const SpeedLadder *ladder,
+                             const DelayGainTable *gains,
+                             const sta::SceneSeq &scenes,
+                             MetricsRecorder *metrics)
+    : sta_(sta),
+      ladder_(ladder),
+      gains_(gains),
+      scenes_(scenes),
+      metrics_(metrics) {}
+
+// Run timer to get violating paths (one per endpoint). The `to` exception is
+// owned and deleted by the search.
+sta::PathEndSeq EndpointCache::findViolatingEnds(sta::ExceptionTo *to) {
+  MetricsRecorder::Scope timing(metrics_, Phase::find_paths);
+  sta::StringSeq group_names;  // empty = report all path groups
+
+  return sta_->findPathEnds(
+      /*exception from*/ nullptr, /*exception through*/ nullptr,
+      /*exception to*/ to, /*unconstrained*/ false, /*scenes*/ scenes_,
+      /*min_max*/ sta::MinMaxAll::max(),
+      /*group_count*/ group_count_, /*endpoint_count*/ 1,
+      /*unique_pins*/ true,
+      /*unique_edges*/ true,
+      /*min_slack*/ -1.0e+30, /*max_slack*/ 0.0,
+      /*sort_by_slack*/ false,
+      /*groups->size() ? groups :*/ group_names,
+      /*setup*/ true, /*hold*/ false,
+      /*recovery*/ false, /*removal*/ false,
+      /*clk_gating_setup*/ false, /*clk_gating_hold*/ false);
+}
+
+// Snapshot each path with negative slack before the search frees it. The
+// backtraces only read the path ends, so they are split across the STA
+// threads in contiguous chunks that keep the endpoint order. The loads their
+// steps drive are then looked up once per driver pin, edge and scene on this
+// thread, and the threads rate their steps from that table.
+void EndpointCache::appendPaths(const sta::PathEndSeq &ends) {
+  MetricsRecorder::Scope timing(metrics_, Phase::score);
+  size_t first = paths_.size();
+  std::vector<sta::PathEnd *> violating;
+  for (sta::PathEnd *pathend : ends) {
+    double slack = pathend->slack(sta_);
+    if (slack >= 0.0) continue;
+    EndpointPath &ep = paths_.emplace_back();
+    ep.vertex = pathend->vertex(sta_);
+    ep.slack = slack;
+    ep.clock = pathend->targetClk(sta_);
+    violating.push_back(pathend);
+  }
+
+  int thread_count = usefulThreads(sta_->threadCount(), violating.size());
+  std::vector<size_t> visited(thread_count, 0);
+  std::vector<std::vector<PendingGain>> pending(violating.size());
+  std::vector<DrivenLoads::KeySet> keys(thread_count);
+  runThreads(thread_count, [&](int thread) {
+    auto [begin, end] = threadChunk(thread, thread_count, violating.size());
+    for (size_t i = begin; i < end; i++)
+      visited[thread] += backtrace(sta_, ladder_, gains_,
+                                   violating[i]->path(),
+                                   paths_[first + i].steps, pending[i],
+                                   keys[thread]);
+  });
+  DrivenLoads loads;
+  for (const DrivenLoads::KeySet &thread_keys : keys)
+    loads.lookUp(sta_, thread_keys);
+  runThreads(thread_count, [&](int thread) {
+    auto [begin, end] = threadChunk(thread, thread_count, violating.size());
+    for (size_t i = begin; i < end; i++)
+      resolveGains(gains_, loads, pending[i], paths_[first + i].steps);
+  });
+  if (metrics_ && !metrics_->empty())
+    for (size_t count : visited) metrics_->current().path_pins += count;
+}
+
+// Visit the path ends of `endpoints` without materializing them, in
+// endpoint order. VisitPathEnds works on the search's shared path state, and
+// OpenSTA only ever drives it from one thread, so neither do we.
+void EndpointCache::streamPaths(const std::vector<sta::Vertex *> &endpoints) {
+  MetricsRecorder::Scope timing(metrics_, Phase::find_paths);
+  sta_->updateTiming(false);
+
+  bool all_scenes = scenes_.size() == sta_->scenes().size();
+  sta::VisitPathEnds visit_ends(sta_);
+  WorstPathVisitor visitor(sta_, ladder_, gains_,
+                           all_scenes ? nullptr : &scenes_);
+  // Max-heap on slack of the worst group count endpoints seen so far, cached
+  // ones included, each with its position in the cache. Once it is full an
+  // endpoint has to beat the least violating one to get in, and is not even
+  // backtraced otherwise.
+  struct Ranked {
+    size_t order;
+    EndpointPath path;
+  };
+  auto less_violating = [](const Ranked &a, const Ranked &b) {
+    return a.path.slack < b.path.slack;
+  };
+  size_t limit = group_count_;
+  std::vector<Ranked> worst;
+  worst.reserve(std::min(paths_.size() + endpoints.size(), limit));
+  for (size_t i = 0; i < paths_.size(); i++)
+    worst.push_back({i, std::move(paths_[i])});
+  std::make_heap(worst.begin(), worst.end(), less_violating);
+  for (; worst.size() > limit; worst.pop_back())
+    std::pop_heap(worst.begin(), worst.end(), less_violating);
+  size_t cached = paths_.size();
+  paths_.clear();
+
+  for (size_t i = 0; i < endpoints.size(); i++) {
+    bool full = worst.size() == limit;
+    visitor.reset(full ? worst.front().path.slack : 0.0);
+    visit_ends.visitPathEnds(endpoints[i], &visitor);
+    if (!visitor.found) continue;
+    if (full) {
+      std::pop_heap(worst.begin(), worst.end(), less_violating);
+      worst.pop_back();
+    }
+    worst.push_back({cached + i,
+                     {endpoints[i], visitor.slack, std::move(visitor.steps),
+                      visitor.clock}});
+    std::push_heap(worst.begin(), worst.end(), less_violating);
+  }
+  if (metrics_ && !metrics_->empty())
+    metrics_->current().path_pins += visitor.visited;
+
+  // Keep the survivors in cache and endpoint order
+  std::sort(worst.begin(), worst.end(), [](const Ranked &a, const Ranked &b) {
+    return a.order < b.order;
+  });
+  for (Ranked &ranked : worst) paths_.push_back(std::move(ranked.path));
+}
+
+void EndpointCache::checkMemoryBudget() {
+  if (!memory_budget_) return;
+  size_t rss = currentRssBytes();
+  if (rss >= memory_budget_ / 10 * 9)
+    group_count_ = std::max(MIN_GROUP_COUNT, group_count_ / 2);
+  else if (rss < memory_budget_ / 2)
+    group_count_ = std::min(DEFAULT_GROUP_COUNT, group_count_ * 2);
+}
+
+void EndpointCache::refreshAll() {
+  checkMemoryBudget();
+  paths_.clear();
+  if (streaming_) {
+    std::vector<sta::Vertex *> endpoints;
+    for (sta::Vertex *vertex : *sta_->search()->endpoints())
+      endpoints.push_back(vertex);
+    streamPaths(endpoints);
+  } else {
+    appendPaths(findViolatingEnds(nullptr));
+  }
+  last_refresh_count_ = paths_.size();
+}
+
+void EndpointCache::adopt(std::vector<EndpointPath> paths, int group_count,
+                          size_t refresh_count) {
+  paths_ = std::move(paths);
+  group_count_ = group_count;
+  last_refresh_count_ = refresh_count;
+}
+
+void EndpointCache::refreshEndpoints(
+    const std::vector<sta::Vertex *> &endpoints) {
+  checkMemoryBudget();
+  paths_.clear();
+  streamPaths(endpoints);
+  last_refresh_count_ = endpoints.size();
+}
+
+void EndpointCache::refreshFanout(
+    const std::vector<sta::Instance *> &changed) {
+  checkMemoryBudget();
+  sta::PinSet *dirty;
+  {
+    MetricsRecorder::Scope timing(metrics_, Phase::find_paths);
+    dirty = fanoutEndpoints(changed);
+  }
+  last_refresh_count_ = dirty->size();
+  if (dirty->empty()) {
+    delete dirty;
+    return;
+  }
+
+  // Forget the stale paths, then re-query only the dirty endpoints. The ones
+  // that no longer violate simply do not come back.
+  paths_.erase(std::remove_if(paths_.begin(), paths_.end(),
+                              [dirty](const EndpointPath &ep) {
+                                return dirty->count(ep.vertex->pin()) != 0;
+                              }),
+               paths_.end());
+  if (streaming_) {
+    std::vector<sta::Vertex *> endpoints;
+    for (const sta::Pin *pin : *dirty)
+      endpoints.push_back(sta_->graph()->pinLoadVertex(pin));
+    delete dirty;
+    streamPaths(endpoints);
+    return;
+  }
+  sta::ExceptionTo *to = sta_->makeExceptionTo(
+      dirty, nullptr, nullptr, sta::RiseFallBoth::riseFall(),
+      sta::RiseFallBoth::riseFall());
+  appendPaths(findViolatingEnds(to));
+}
+
+bool EndpointCache::hasOffenders() const {
+  for (const EndpointPath &ep : paths_)
+    if (!ep.steps.empty()) return true;
+  return false;
+}
+
+// Collect the timing endpoints whose arrival or required time can move when
+// `changed` get new cells: everything downstream of the changed instances and
+// of the drivers of their input nets, whose load changed with them. Clock
+// pins are followed through their check edges, so capture-side changes are
+// covered as well.
+sta::PinSet *EndpointCache::fanoutEndpoints(
+    const std::vector<sta::Instance *> &changed) {
+  sta::Network *network = sta_->network();
+  sta::Graph *graph = sta_->graph();
+  sta::Search *search = sta_->search();
+
+  std::unordered_set<sta::Vertex *> visited;
+  std::vector<sta::Vertex *> stack;
+  auto visit = [&visited, &stack](sta::Vertex *vertex) {
+    if (vertex && visited.insert(vertex).second) stack.push_back(vertex);
+  };
+
+  for (sta::Instance *inst : changed) {
+    std::unique_ptr<sta::InstancePinIterator> pins(network->pinIterator(inst));
+    while (pins->hasNext()) {
+      sta::Pin *pin = pins->next();
+      visit(graph->pinDrvrVertex(pin));
+      sta::Vertex *load = graph->pinLoadVertex(pin);
+      if (!load) continue;
+      sta::VertexInEdgeIterator edges(load, graph);
+      while (edges.hasNext()) {
+        sta::Edge *edge = edges.next();
+        if (edge->isWire()) visit(edge->from(graph));
+      }
+    }
+  }
+
+  sta::PinSet *endpoints = new sta::PinSet(network);
+  while (!stack.empty()) {
+    sta::Vertex *vertex = stack.back();
+    stack.pop_back();
+    if (search->isEndpoint(vertex)) endpoints->insert(vertex->pin());
+    sta::VertexOutEdgeIterator edges(vertex, graph);
+    while (edges.hasNext()) visit(edges.next()->to(graph));
+  }
+  return endpoints;
+}
+
+}  // namespace silisizer
@@ -0,0 +1,109 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <vector>
+
+#include "DelayGain.h"
+#include "Metrics.h"
+#include "SpeedLadder.h"
+#include "sta/Sta.hh"
+
+namespace silisizer {
+
+// A resizable instance on a violating path and the delay that upsizing it
+// would remove from the timing arc that enters it.
+struct PathStep {
+  sta::Instance *inst;
+  float gain;
+};
+
+// The worst violating path to one endpoint, reduced to what the sizer scores.
+// PathEnds are owned by the search and die on the next query, so nothing here
+// points into them.
+struct EndpointPath {
+  sta::Vertex *vertex;
+  double slack;
+  std::vector<PathStep> steps;
+  // Clock capturing the endpoint, or nullptr if there is none
+  const sta::Clock *clock = nullptr;
+};
+
+// Violating endpoints kept between sizing iterations. A full refresh re-times
+// every endpoint; an incremental refresh re-queries only the endpoints in the
+// fanout cones of the instances swapped by the previous batch and reuses the
+// cached paths of everything else.
+class EndpointCache {
+ public:
+  // Time the endpoints of `scenes`, rating path steps with `gains`. Timer
+  // queries and backtraces are charged to the current iteration of `metrics`.
+  EndpointCache(sta::Sta *sta, const SpeedLadder *ladder,
+                const DelayGainTable *gains, const sta::SceneSeq &scenes,
+                MetricsRecorder *metrics);
+
+  // Re-time every endpoint and replace the cache.
+  void refreshAll();
+  // Re-time the endpoints whose slack may have changed because `changed`
+  // were resized.
+  void refreshFanout(const std::vector<sta::Instance *> &changed);
+  // Re-time only `endpoints`, streaming their paths, and replace the cache.
+  void refreshEndpoints(const std::vector<sta::Vertex *> &endpoints);
+
+  // Replace the cache with `paths` refreshed by a worker process forked from
+  // this one, along with the group count and refresh count it ended with.
+  void adopt(std::vector<EndpointPath> paths, int group_count,
+             size_t refresh_count);
+
+  // Snapshot each path end while the search visits it instead of
+  // materializing a PathEndSeq for the whole query.
+  void setStreaming(bool streaming) { streaming_ = streaming; }
+  // Halve the group count before a refresh whenever RSS is above 90% of
+  // `bytes`, and double it back towards the default once RSS is below half
+  // of it (0 = no budget).
+  void setMemoryBudget(size_t bytes) { memory_budget_ = bytes; }
+  // Most violating endpoints kept per path group (per cache when streaming).
+  int groupCount() const { return group_count_; }
+
+  const std::vector<EndpointPath> &paths() const { return paths_; }
+  // True if any cached path goes through a resizable instance.
+  bool hasOffenders() const;
+  // Number of endpoints re-queried by the last refresh.
+  size_t lastRefreshCount() const { return last_refresh_count_; }
+
+ private:
+  static constexpr int DEFAULT_GROUP_COUNT = 10000;
+  static constexpr int MIN_GROUP_COUNT = 100;
+
+  sta::PathEndSeq findViolatingEnds(sta::ExceptionTo *to);
+  void appendPaths(const sta::PathEndSeq &ends);
+  void streamPaths(const std::vector<sta::Vertex *> &endpoints);
+  void checkMemoryBudget();
+  sta::PinSet *fanoutEndpoints(const std::vector<sta::Instance *> &changed);
+
+  sta::Sta *sta_;
+  const SpeedLadder *ladder_;
+  const DelayGainTable *gains_;
+  sta::SceneSeq scenes_;
+  MetricsRecorder *metrics_;
+  bool streaming_ = false;
+  size_t memory_budget_ = 0;
+  int group_count_ = DEFAULT_GROUP_COUNT;
+  std::vector<EndpointPath> paths_;
+  size_t last_refresh_count_ = 0;
+};
+
+}  // namespace silisizer
@@ -0,0 +1,235 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+#include "FoldIndex.h"
+
+#include <chrono>
+#include <cstring>
+#include <utility>
+
+#include "sta/Liberty.hh"
+#include "sta/Network.hh"
+
+namespace silisizer {
+
+// Rough per-entry cost of a node-based hash table entry beyond its payload
+const size_t HASH_NODE_OVERHEAD = 2 * sizeof(void *);
+
+void reverseOpenSTANaming(std::string_view name, std::string &out) {
+  out.clear();
+  for (size_t i = 0; i < name.size(); i++) {
+    char c = name[i];
+    // Drop the escape in front of \[ \] \/ and \\ in a single pass
+    if (c == '\\' && i + 1 < name.size()) {
+      char next = name[i + 1];
+      if (next == '[' || next == ']' || next == '/' || next == '\\') {
+        out.push_back(next);
+        i++;
+        continue;
+      }
+    }
+    out.push_back(c);
+  }
+}
+
+uint32_t NameArena::intern(std::string_view name) {
+  auto it = ids_.find(name);
+  if (it != ids_.end()) return it->second;
+
+  // Long names get a block of their own so they do not waste the shared one
+  char *dst;
+  if (name.size() > BLOCK_SIZE / 4) {
+    blocks_.emplace_back(new char[name.size()]);
+    block_bytes_ += name.size();
+    dst = blocks_.back().get();
+  } else {
+    if (block_used_ + name.size() > BLOCK_SIZE) {
+      blocks_.emplace_back(new char[BLOCK_SIZE]);
+      block_bytes_ += BLOCK_SIZE;
+      block_ = blocks_.back().get();
+      block_used_ = 0;
+    }
+    dst = block_ + block_used_;
+    block_used_ += name.size();
+  }
+  if (!name.empty()) std::memcpy(dst, name.data(), name.size());
+
+  uint32_t id = names_.size();
+  names_.emplace_back(dst, name.size());
+  ids_.emplace(names_.back(), id);
+  return id;
+}
+
+bool NameArena::find(std::string_view name, uint32_t &id) const {
+  auto it = ids_.find(name);
+  if (it == ids_.end()) return false;
+  id = it->second;
+  return true;
+}
+
+size_t NameArena::bytes() const {
+  return block_bytes_ + names_.capacity() * sizeof(std::string_view) +
+         ids_.size() * (sizeof(std::string_view) + sizeof(uint32_t) +
+                        HASH_NODE_OVERHEAD) +
+         ids_.bucket_count() * sizeof(void *);
+}
+
+std::string_view HierarchyPrefixes::prefix(const sta::Instance *leaf) {
+  sta::Instance *parent = network_->parent(leaf);
+  if (!parent) return {};
+  return hierPrefix(parent);
+}
+
+// Prefix of the leaves under `inst`: its own name, then its parents' (inner
+// first). Uncached ancestors are filled in from the nearest cached one down.
+const std::string &HierarchyPrefixes::hierPrefix(sta::Instance *inst) {
+  auto cached = prefixes_.find(inst);
+  if (cached != prefixes_.end()) return cached->second;
+
+  std::vector<sta::Instance *> chain;
+  const std::string *outer = nullptr;
+  for (sta::Instance *hier = inst; hier; hier = network_->parent(hier)) {
+    auto found = prefixes_.find(hier);
+    if (found != prefixes_.end()) {
+      outer = &found->second;
+      break;
+    }
+    chain.push_back(hier);
+  }
+
+  const std::string *prefix = outer;
+  for (auto hier = chain.rbegin(); hier != chain.rend(); ++hier) {
+    reverseOpenSTANaming(network_->name(*hier), name_);
+    std::string own = name_.empty() ? std::string() : name_ + ".";
+    if (prefix) own += *prefix;
+    prefix = &prefixes_.emplace(*hier, std::move(own)).first->second;
+  }
+  return *prefix;
+}
+
+FoldIndex::FoldIndex(sta::Network *network, const SpeedLadder &ladder) {
+  auto start = std::chrono::steady_clock::now();
+
+  // Populate groups of resizable leaf copies by (module, cell)
+  // {
+  //   (module1, cell1) -> [leaf instances]
+  //   (module1, cell2) -> [leaf instances]
+  //   (module2, cell1) -> [leaf instances]
+  //   ...
+  // }
+  // Module names are interned once per hierarchical cell and leaf names are
+  // unescaped into a reused buffer, so the walk does not allocate per leaf.
+  std::unordered_map<const sta::Cell *, uint32_t> module_ids;
+  std::vector<std::pair<uint32_t, sta::Instance *>> members;
+  std::string cell_name;
+  std::unique_ptr<sta::LeafInstanceIterator> leaves(
+      network->leafInstanceIterator());
+  while (leaves->hasNext()) {  // loop over all leaves
+    sta::Instance *leaf = leaves->next();
+    sta::Instance *parent = network->parent(leaf);
+    if (!parent) continue;
+    sta::LibertyCell *leaf_lib = network->libertyCell(network->cell(leaf));
+    if (!leaf_lib || !ladder.isResizable(leaf_lib)) continue;
+
+    auto [module_it, inserted] =
+        module_ids.try_emplace(network->cell(parent), 0);
+    if (inserted) module_it->second = names_.intern(network->cellName(parent));
+    reverseOpenSTANaming(network->name(leaf), cell_name);
+    uint32_t module = module_it->second;
+    uint32_t cell = names_.intern(cell_name);
+
+    uint64_t key = slotKey(module, cell);
+    if (2 * (groups_.size() + 1) > slot_keys_.size()) growTable();
+    size_t slot = probe(key);
+    if (slot_keys_[slot] == EMPTY_KEY) {
+      slot_keys_[slot] = key;
+      slot_groups_[slot] = groups_.size();
+      groups_.push_back({module, cell});
+    }
+    members.emplace_back(slot_groups_[slot], leaf);
+  }
+
+  // Lay the leaves out contiguously per group (counting sort)
+  offsets_.assign(groups_.size() + 1, 0);
+  for (const auto &member : members) offsets_[member.first + 1]++;
+  for (size_t group = 0; group < groups_.size(); group++)
+    offsets_[group + 1] += offsets_[group];
+  std::vector<uint32_t> fill(offsets_.begin(), offsets_.end() - 1);
+  leaves_.resize(members.size());
+  leaf_group_.reserve(members.size());
+  for (const auto &[group, leaf] : members) {
+    leaves_[fill[group]++] = leaf;
+    leaf_group_.emplace(leaf, group);
+  }
+
+  build_seconds_ = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+}
+
+int FoldIndex::find(std::string_view module, std::string_view cell) const {
+  uint32_t module_id, cell_id;
+  if (slot_keys_.empty() || !names_.find(module, module_id) ||
+      !names_.find(cell, cell_id))
+    return -1;
+  size_t slot = probe(slotKey(module_id, cell_id));
+  return slot_keys_[slot] == EMPTY_KEY ? -1 : (int) slot_groups_[slot];
+}
+
+size_t FoldIndex::bytes() const {
+  return names_.bytes() + groups_.capacity() * sizeof(Group) +
+         slot_keys_.capacity() * sizeof(uint64_t) +
+         slot_groups_.capacity() * sizeof(uint32_t) +
+         leaves_.capacity() * sizeof(sta::Instance *) +
+         offsets_.capacity() * sizeof(uint32_t) +
+         leaf_group_.size() * (sizeof(void *) + sizeof(uint32_t) +
+                               HASH_NODE_OVERHEAD) +
+         leaf_group_.bucket_count() * sizeof(void *);
+}
+
+// splitmix64 finalizer: the ids are small and dense, so spread them out
+size_t FoldIndex::slotHash(uint64_t key) {
+  key ^= key >> 30;
+  key *= 0xbf58476d1ce4e5b9ull;
+  key ^= key >> 27;
+  key *= 0x94d049bb133111ebull;
+  key ^= key >> 31;
+  return (size_t) key;
+}
+
+size_t FoldIndex::probe(uint64_t key) const {
+  size_t mask = slot_keys_.size() - 1;
+  size_t slot = slotHash(key) & mask;
+  while (slot_keys_[slot] != EMPTY_KEY && slot_keys_[slot] != key)
+    slot = (slot + 1) & mask;
+  return slot;
+}
+
+// Double the table (kept at most half full for short linear probes)
+void FoldIndex::growTable() {
+  std::vector<uint64_t> old_keys = std::move(slot_keys_);
+  std::vector<uint32_t> old_groups = std::move(slot_groups_);
+  size_t capacity = old_keys.empty() ? 1024 : 2 * old_keys.size();
+  slot_keys_.assign(capacity, EMPTY_KEY);
+  slot_groups_.assign(capacity, 0);
+  for (size_t i = 0; i < old_keys.size(); i++) {
+    if (old_keys[i] == EMPTY_KEY) continue;
+    size_t slot = probe(old_keys[i]);
+    slot_keys_[slot] = old_keys[i];
+    slot_groups_[slot] = old_groups[i];
+  }
+}
+
+}  // namespace silisizer
@@ -0,0 +1,148 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "SpeedLadder.h"
+#include "sta/Sta.hh"
+
+namespace silisizer {
+
+// Reverse the internal naming convention used by OpenSTA for readback,
+// writing the unescaped name into `out` (reused to avoid allocation)
+void reverseOpenSTANaming(std::string_view name, std::string &out);
+
+// Append-only store of interned names. Names live in large blocks that never
+// move, so ids and views stay valid for the lifetime of the arena.
+class NameArena {
+ public:
+  // Id of `name`, interning a copy the first time it is seen
+  uint32_t intern(std::string_view name);
+  // Id of an already interned `name`; false if it was never interned
+  bool find(std::string_view name, uint32_t &id) const;
+  std::string_view name(uint32_t id) const { return names_[id]; }
+  size_t size() const { return names_.size(); }
+  size_t bytes() const;
+
+ private:
+  static constexpr size_t BLOCK_SIZE = 1 << 16;
+
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  char *block_ = nullptr;
+  size_t block_used_ = BLOCK_SIZE;
+  size_t block_bytes_ = 0;
+  std::vector<std::string_view> names_;
+  std::unordered_map<std::string_view, uint32_t> ids_;
+};
+
+// Log prefixes of leaf instances ("parent.grandparent."), built and
+// unescaped once per hierarchical instance and shared by all its leaves.
+class HierarchyPrefixes {
+ public:
+  explicit HierarchyPrefixes(sta::Network *network) : network_(network) {}
+  // Prefix of `leaf`, kept for the lifetime of the cache
+  std::string_view prefix(const sta::Instance *leaf);
+
+ private:
+  const std::string &hierPrefix(sta::Instance *inst);
+
+  sta::Network *network_;
+  std::unordered_map<const sta::Instance *, std::string> prefixes_;
+  std::string name_;
+};
+
+// Resizable leaf copies grouped by (module, cell). A resize always applies to
+// every folded copy of a cell in its module, and Preqorsor back-annotates it
+// by the same (module name, cell name) pair. Module and cell names are
+// interned once; groups are found through a flat open-addressing table keyed
+// by the pair of ids, and their leaves are stored contiguously.
+class FoldIndex {
+ public:
+  FoldIndex(sta::Network *network, const SpeedLadder &ladder);
+
+  // Group of `leaf`, or -1 if it was not resizable when the index was built
+  int find(const sta::Instance *leaf) const {
+    auto it = leaf_group_.find(leaf);
+    return it == leaf_group_.end() ? -1 : (int) it->second;
+  }
+  // Group of the (module, cell) pair, or -1
+  int find(std::string_view module, std::string_view cell) const;
+
+  std::string_view moduleName(int group) const {
+    return names_.name(groups_[group].module);
+  }
+  std::string_view cellName(int group) const {
+    return names_.name(groups_[group].cell);
+  }
+
+  // Folded leaf copies of `group`
+  struct LeafRange {
+    sta::Instance *const *first;
+    sta::Instance *const *last;
+    sta::Instance *const *begin() const { return first; }
+    sta::Instance *const *end() const { return last; }
+    size_t size() const { return last - first; }
+  };
+  LeafRange leaves(int group) const {
+    return {leaves_.data() + offsets_[group],
+            leaves_.data() + offsets_[group + 1]};
+  }
+
+  size_t groupCount() const { return groups_.size(); }
+  size_t leafCount() const { return leaves_.size(); }
+  size_t nameCount() const { return names_.size(); }
+  // Memory held by the index
+  size_t bytes() const;
+  // Wall time spent building the index
+  double buildSeconds() const { return build_seconds_; }
+
+ private:
+  struct Group {
+    uint32_t module;
+    uint32_t cell;
+  };
+  static uint64_t slotKey(uint32_t module, uint32_t cell) {
+    return ((uint64_t) module << 32) | cell;
+  }
+  static size_t slotHash(uint64_t key);
+  // Slot holding `key`, or the empty slot where it belongs
+  size_t probe(uint64_t key) const;
+  void growTable();
+
+  static constexpr uint64_t EMPTY_KEY = ~(uint64_t) 0;
+
+  NameArena names_;
+  std::vector<Group> groups_;
+  // Open-addressing table: slot_keys_[i] == EMPTY_KEY or holds the group
+  // slot_groups_[i]
+  std::vector<uint64_t> slot_keys_;
+  std::vector<uint32_t> slot_groups_;
+  // Leaves of group g are leaves_[offsets_[g] .. offsets_[g + 1])
+  std::vector<sta::Instance *> leaves_;
+  std::vector<uint32_t> offsets_;
+  std::unordered_map<const sta::Instance *, uint32_t> leaf_group_;
+  double build_seconds_ = 0.0;
+};
+
+}  // namespace silisizer
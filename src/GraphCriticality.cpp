@@ -0,0 +1,155 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+#include "GraphCriticality.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include "sta/Graph.hh"
+#include "sta/Liberty.hh"
+#include "sta/Network.hh"
+#include "sta/Path.hh"
+#include "sta/Search.hh"
+#include "sta/TimingArc.hh"
+#include "sta/TimingRole.hh"
+
+namespace silisizer {
+
+namespace {
+
+// Violating endpoints whose worst path has reached one path node, by slack.
+// Every endpoint sits in exactly one list at a time: a node's list moves on
+// to its predecessor once the node is scored.
+struct EndpointSlacks {
+  std::vector<double> slacks;
+  // Smallest violation in `slacks`; gains up to it are never capped
+  double least_violation = 0.0;
+
+  void add(double slack) {
+    least_violation = slacks.empty() ? -slack
+                                     : std::min(least_violation, -slack);
+    slacks.push_back(slack);
+  }
+  // Move `other` in, copying the shorter list into the longer one
+  void merge(EndpointSlacks &other) {
+    if (other.slacks.empty()) return;
+    least_violation = slacks.empty()
+                          ? other.least_violation
+                          : std::min(least_violation, other.least_violation);
+    if (slacks.size() < other.slacks.size()) slacks.swap(other.slacks);
+    slacks.insert(slacks.end(), other.slacks.begin(), other.slacks.end());
+    other.slacks.clear();
+    other.slacks.shrink_to_fit();
+  }
+  // Sum of `gain` capped at each endpoint's violation
+  double cappedSum(double gain) const {
+    if (gain <= least_violation) return gain * slacks.size();
+    double sum = 0.0;
+    for (double slack : slacks) sum += std::min(gain, -slack);
+    return sum;
+  }
+};
+
+}  // namespace
+
+// Delay that upsizing the instance of `path`'s pin would remove from the arc
+// entering it, as backtrace() in EndpointCache.cpp rates it
+static float pathGain(const sta::Sta *sta, const DelayGainTable *gains,
+                      const sta::Path *path, const sta::TimingArc *prev_arc) {
+  if (!prev_arc) return 0.0f;
+  int entry = gains->find(prev_arc);
+  if (entry < 0) return prev_arc->intrinsicDelay();
+  return gains->gain(entry, drivenLoad(sta, path->pin(sta),
+                                       path->transition(sta),
+                                       path->scene(sta)));
+}
+
+GraphCriticality scoreGraph(sta::Sta *sta, const SpeedLadder *ladder,
+                            const DelayGainTable *gains,
+                            MetricsRecorder *metrics) {
+  GraphCriticality result;
+
+  // Bring every arrival and required time up to date in one search; the
+  // endpoint slacks and worst paths below are then plain lookups
+  {
+    MetricsRecorder::Scope timing(metrics, Phase::find_paths);
+    sta::Slack worst;
+    sta::Vertex *worst_vertex;
+    sta->worstSlack(sta::MinMax::max(), worst, worst_vertex);
+    if (worst >= 0.0) return result;
+  }
+
+  MetricsRecorder::Scope timing(metrics, Phase::score);
+  sta::Network *network = sta->network();
+
+  // The worst path of every violating endpoint, as stored by the search.
+  // Each path node has one predecessor, so together they form a tree rooted
+  // at the endpoints, bucketed here by level so a node is scored only after
+  // every endpoint that reaches it has arrived.
+  std::unordered_map<const sta::Path *, EndpointSlacks> reached;
+  std::vector<std::vector<const sta::Path *>> levels;
+  auto reach = [&](const sta::Path *path) -> EndpointSlacks & {
+    auto [it, inserted] = reached.try_emplace(path);
+    if (inserted) {
+      size_t level = path->vertex(sta)->level();
+      if (level >= levels.size()) levels.resize(level + 1);
+      levels[level].push_back(path);
+    }
+    return it->second;
+  };
+  for (sta::Vertex *vertex : *sta->search()->endpoints()) {
+    double slack = sta->vertexSlack(vertex, sta::MinMax::max());
+    if (slack >= 0.0) continue;
+    const sta::Path *path =
+        sta->vertexWorstSlackPath(vertex, sta::MinMax::max());
+    if (!path || path->isNull()) continue;
+    result.violating_endpoints++;
+    result.wns = std::min(result.wns, slack);
+    result.tns += slack;
+    reach(path).add(slack);
+  }
+
+  // Score every node once for all the endpoints it carries, capping the gain
+  // at each endpoint's own violation, then hand them to the predecessor
+  size_t ordinal = 0;
+  for (size_t level = levels.size(); level-- > 0;) {
+    // By index: a predecessor on the same level lands in this bucket
+    for (size_t i = 0; i < levels[level].size(); i++) {
+      const sta::Path *path = levels[level][i];
+      EndpointSlacks &endpoints = reached[path];
+      const sta::TimingArc *prev_arc = path->prevArc(sta);
+      // Past a transparent latch the path is in a different launch cycle
+      if (prev_arc && prev_arc->role()->isLatchDtoQ()) continue;
+
+      sta::Instance *inst = network->instance(path->pin(sta));
+      sta::Cell *cell = network->cell(inst);
+      sta::LibertyCell *libcell = cell ? network->libertyCell(cell) : nullptr;
+      if (libcell && ladder->isResizable(libcell)) {
+        double gain = pathGain(sta, gains, path, prev_arc);
+        auto [it, inserted] = result.scores.try_emplace(inst);
+        if (inserted) it->second.first_seen = ordinal++;
+        it->second.score += endpoints.cappedSum(gain);
+      }
+
+      const sta::Path *prev = path->prevPath();
+      if (prev && !prev->isNull()) reach(prev).merge(endpoints);
+    }
+  }
+  return result;
+}
+
+}  // namespace silisizer
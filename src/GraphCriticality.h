@@ -0,0 +1,50 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+
+#include "DelayGain.h"
+#include "Metrics.h"
+#include "OffenderScore.h"
+#include "SpeedLadder.h"
+#include "sta/Sta.hh"
+
+namespace silisizer {
+
+// Offender scores and violation summary from one pass over the timing graph
+struct GraphCriticality {
+  OffenderScores scores;
+  double wns = 0.0;
+  double tns = 0.0;
+  size_t violating_endpoints = 0;
+};
+
+// Score resizable instances straight from the worst paths the search keeps,
+// without building any PathEnd. Every violating endpoint's worst path is
+// followed back through the stored predecessor of each path node; shared
+// prefixes form a tree that is walked once, from the highest level down,
+// carrying the slacks of the endpoints below each node. A resizable
+// instance on a node scores its arc gain from `gains`, capped at each of
+// those endpoints' violation: the same sum scorePaths() forms over one
+// worst path per endpoint, with no group count limit and each shared prefix
+// visited once.
+GraphCriticality scoreGraph(sta::Sta *sta, const SpeedLadder *ladder,
+                            const DelayGainTable *gains,
+                            MetricsRecorder *metrics);
+
+}  // namespace silisizer
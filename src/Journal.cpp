@@ -0,0 +1,131 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+#include "Journal.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace silisizer {
+
+// Journal layout, one batch at a time:
+//   batch <TAB> iter <TAB> next_swaps_per_iter <TAB> stall_rounds <TAB> wns
+//   swap <TAB> module <TAB> cell
+//   ...
+//   end
+const char *const JOURNAL_HEADER = "# silisize journal v1";
+
+bool ResizeJournal::read(const std::string &path,
+                         std::vector<JournalBatch> &batches) {
+  std::ifstream in(path);
+  if (!in.good()) return false;
+
+  JournalBatch batch;
+  bool in_batch = false;
+  std::string line;
+  while (std::getline(in, line)) {
+    std::istringstream fields(line);
+    std::string kind;
+    std::getline(fields, kind, '\t');
+    if (kind == "batch") {
+      batch = JournalBatch();
+      fields >> batch.iter >> batch.next_swaps_per_iter >>
+          batch.wns_stall_rounds >> batch.wns;
+      in_batch = !fields.fail();
+    } else if (kind == "swap" && in_batch) {
+      std::string module, cell;
+      if (std::getline(fields, module, '\t') && std::getline(fields, cell))
+        batch.swaps.emplace_back(module, cell);
+      else
+        in_batch = false;
+    } else if (kind == "end" && in_batch) {
+      batches.push_back(std::move(batch));
+      in_batch = false;
+    }
+  }
+  return true;
+}
+
+// True if the journal at `path` ends right after a complete batch
+static bool endsWithBatch(const std::string &path) {
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  const std::string end = "end\n";
+  if (!in.good() || in.tellg() < (std::streamoff) end.size()) return false;
+  in.seekg(-(std::streamoff) end.size(), std::ios::end);
+  std::string tail(end.size(), '\0');
+  in.read(&tail[0], tail.size());
+  return in.good() && tail == end;
+}
+
+bool ResizeJournal::replace(const std::string &path,
+                            const std::vector<JournalBatch> &batches) {
+  std::string temp_path = path + ".tmp";
+  {
+    std::ofstream out(temp_path, std::ios::out | std::ios::trunc);
+    out << JOURNAL_HEADER << '\n';
+    for (const JournalBatch &batch : batches) write(out, batch);
+    out.close();
+    if (out.fail()) return false;
+  }
+#ifdef __linux__
+  int fd = ::open(temp_path.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  bool synced = fsync(fd) == 0;
+  close(fd);
+  if (!synced) return false;
+#endif
+  return std::rename(temp_path.c_str(), path.c_str()) == 0;
+}
+
+bool ResizeJournal::open(const std::string &path,
+                         const std::vector<JournalBatch> &batches) {
+  path_ = path;
+  // A journal cut short by a crash is compacted to its complete batches,
+  // since new records must not be appended to a torn line
+  if ((batches.empty() || !endsWithBatch(path)) && !replace(path, batches))
+    return false;
+  stream_.open(path, std::ios::out | std::ios::app);
+  return stream_.good();
+}
+
+void ResizeJournal::append(const JournalBatch &batch, Logger &log) {
+  if (!stream_.is_open()) return;
+  write(stream_, batch);
+  stream_.flush();
+  if (!stream_.good()) {
+    log.error() << "silisize: failed writing " << path_
+                << ", resume journal disabled";
+    stream_.close();
+  }
+}
+
+void ResizeJournal::write(std::ostream &out, const JournalBatch &batch) {
+  out << "batch\t" << batch.iter << '\t' << batch.next_swaps_per_iter << '\t'
+      << batch.wns_stall_rounds << '\t'
+      << std::setprecision(std::numeric_limits<double>::max_digits10)
+      << batch.wns << '\n';
+  for (const auto &[module, cell] : batch.swaps)
+    out << "swap\t" << module << '\t' << cell << '\n';
+  out << "end\n";
+}
+
+}  // namespace silisizer
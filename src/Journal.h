@@ -0,0 +1,70 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Logger.h"
+
+namespace silisizer {
+
+// One sizing iteration as recorded in the journal
+struct JournalBatch {
+  int iter = 0;
+  // Batch size and WNS stall count the next iteration starts from
+  int next_swaps_per_iter = 1;
+  int wns_stall_rounds = 0;
+  // WNS measured before the batch was applied
+  double wns = 0.0;
+  // Upsized (module, cell) pairs, in order
+  std::vector<std::pair<std::string, std::string>> swaps;
+};
+
+// Append-only log of sizing batches, so that a killed run can be resumed.
+// Each batch is written whole and flushed; a batch cut short by a crash has
+// no end marker and is ignored when the journal is read back.
+class ResizeJournal {
+ public:
+  // Read the complete batches of the journal at `path`. Returns false if the
+  // file cannot be opened.
+  static bool read(const std::string &path, std::vector<JournalBatch> &batches);
+
+  // Start the journal at `path` with `batches` already in it: the batches
+  // read back from it to resume from, or none. When the file at `path` ends
+  // with the last of them it is kept and appended to. Otherwise it is
+  // replaced by writing `batches` to a temporary file, syncing it and
+  // renaming it over `path`, so a crash never leaves it half rewritten.
+  // Returns false if it cannot be written.
+  bool open(const std::string &path, const std::vector<JournalBatch> &batches);
+  // Append one batch. A failed write disables the journal with a warning on
+  // `log`, since it only matters for resuming.
+  void append(const JournalBatch &batch, Logger &log);
+
+ private:
+  static void write(std::ostream &out, const JournalBatch &batch);
+  static bool replace(const std::string &path,
+                      const std::vector<JournalBatch> &batches);
+
+  std::string path_;
+  std::ofstream stream_;
+};
+
+}  // namespace silisizer
@@ -0,0 +1,82 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+#include "JsonWriter.h"
+
+namespace silisizer {
+
+static void appendEscaped(std::string &out, char c) {
+  static const char HEX[] = "0123456789abcdef";
+  switch (c) {
+    case '"': out += "\\\""; break;
+    case '\\': out += "\\\\"; break;
+    case '\n': out += "\\n"; break;
+    case '\r': out += "\\r"; break;
+    case '\t': out += "\\t"; break;
+    default:
+      if ((unsigned char) c < 0x20) {
+        out += "\\u00";
+        out.push_back(HEX[(unsigned char) c >> 4]);
+        out.push_back(HEX[c & 0xf]);
+      } else {
+        out.push_back(c);
+      }
+  }
+}
+
+void appendJsonName(std::string &out, std::string_view name) {
+  out.push_back('"');
+  for (char c : name)
+    if (c != '\\') appendEscaped(out, c);
+  out.push_back('"');
+}
+
+JsonWriter::~JsonWriter() {
+  if (file_) close();
+}
+
+bool JsonWriter::open(const char *path) {
+  file_ = std::fopen(path, "w");
+  ok_ = file_ != nullptr;
+  buffer_.reserve(BUFFER_SIZE);
+  return ok_;
+}
+
+void JsonWriter::write(std::string_view text) {
+  if (buffer_.size() + text.size() > BUFFER_SIZE) flush();
+  // Blocks larger than the buffer go straight to the file
+  if (text.size() > BUFFER_SIZE) {
+    ok_ &= std::fwrite(text.data(), 1, text.size(), file_) == text.size();
+    return;
+  }
+  buffer_.append(text);
+}
+
+void JsonWriter::flush() {
+  if (buffer_.empty()) return;
+  ok_ &= std::fwrite(buffer_.data(), 1, buffer_.size(), file_) ==
+         buffer_.size();
+  buffer_.clear();
+}
+
+bool JsonWriter::close() {
+  if (!file_) return false;
+  flush();
+  ok_ &= std::fclose(file_) == 0;
+  file_ = nullptr;
+  return ok_;
+}
+
+}  // namespace silisizer
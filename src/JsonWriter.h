@@ -0,0 +1,50 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+namespace silisizer {
+
+// Append an OpenSTA name as a quoted JSON string, dropping the backslashes
+// OpenSTA escapes special characters with
+void appendJsonName(std::string &out, std::string_view name);
+
+// Streaming writer for large JSON documents: text is collected in a 1 MB
+// buffer and written in big blocks.
+class JsonWriter {
+ public:
+  ~JsonWriter();
+
+  bool open(const char *path);
+  void write(std::string_view text);
+  // Flush and close; false if any write failed
+  bool close();
+
+ private:
+  static constexpr size_t BUFFER_SIZE = 1 << 20;
+
+  void flush();
+
+  std::FILE *file_ = nullptr;
+  std::string buffer_;
+  bool ok_ = true;
+};
+
+}  // namespace silisizer
@@ -0,0 +1,83 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+#include "Logger.h"
+
+namespace silisizer {
+
+Logger::Logger(LogLevel level, std::FILE *out, std::FILE *err)
+    : level_(level), out_(out), err_(err) {
+  writer_ = std::thread(&Logger::run, this);
+}
+
+Logger::~Logger() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    done_ = true;
+  }
+  ready_.notify_one();
+  writer_.join();
+}
+
+Logger::Line::~Line() {
+  if (!logger_) return;
+  stream_ << '\n';
+  if (error_)
+    logger_->writeError(stream_.str());
+  else
+    logger_->write(stream_.str());
+}
+
+void Logger::write(std::string text) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  drained_.wait(lock, [this] { return pending_.size() < QUEUE_BYTES; });
+  pending_ += text;
+  lock.unlock();
+  ready_.notify_one();
+}
+
+void Logger::writeError(const std::string &text) {
+  flush();
+  std::fwrite(text.data(), 1, text.size(), err_);
+  std::fflush(err_);
+}
+
+void Logger::flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  drained_.wait(lock, [this] { return pending_.empty() && !writing_; });
+}
+
+void Logger::run() {
+  std::string block;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    ready_.wait(lock, [this] { return done_ || !pending_.empty(); });
+    if (pending_.empty() && done_) break;
+    block.swap(pending_);
+    writing_ = true;
+    lock.unlock();
+    drained_.notify_all();
+
+    std::fwrite(block.data(), 1, block.size(), out_);
+    std::fflush(out_);
+    block.clear();
+
+    lock.lock();
+    writing_ = false;
+    drained_.notify_all();
+  }
+}
+
+}  // namespace silisizer
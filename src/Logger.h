@@ -0,0 +1,99 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace silisizer {
+
+enum class LogLevel {
+  quiet,    // results and warnings only
+  normal,   // progress and every resize
+  verbose,  // per-pass diagnostic counters
+};
+
+// Console logger for a sizing run. Lines are formatted by the caller and
+// written by a background thread in large blocks; the queue is bounded, so a
+// producer that outruns the console waits instead of growing memory. Errors
+// go to `err` right away, after everything queued before them.
+class Logger {
+ public:
+  explicit Logger(LogLevel level, std::FILE *out = stdout,
+                  std::FILE *err = stderr);
+  ~Logger();
+  Logger(const Logger &) = delete;
+  Logger &operator=(const Logger &) = delete;
+
+  bool enabled(LogLevel level) const { return level <= level_; }
+
+  // One output line, queued when it goes out of scope
+  class Line {
+   public:
+    explicit Line(Logger *logger, bool error = false)
+        : logger_(logger), error_(error) {}
+    Line(const Line &) = delete;
+    Line &operator=(const Line &) = delete;
+    ~Line();
+    template <typename T>
+    Line &operator<<(const T &value) {
+      if (logger_) stream_ << value;
+      return *this;
+    }
+
+   private:
+    Logger *logger_;
+    bool error_;
+    std::ostringstream stream_;
+  };
+  // Line at `level`; formatting is skipped when the level is disabled
+  Line operator()(LogLevel level) {
+    return Line(enabled(level) ? this : nullptr);
+  }
+  // Error line, written at every level
+  Line error() { return Line(this, true); }
+
+  // Queue `text` as is, waiting while the queue is full
+  void write(std::string text);
+  // Flush the queue, then write `text` to the error stream
+  void writeError(const std::string &text);
+  // Return once everything queued so far is on the console
+  void flush();
+
+ private:
+  static constexpr size_t QUEUE_BYTES = 4 << 20;
+
+  void run();
+
+  LogLevel level_;
+  std::FILE *out_;
+  std::FILE *err_;
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::condition_variable drained_;
+  std::string pending_;
+  bool writing_ = false;
+  bool done_ = false;
+  std::thread writer_;
+};
+
+}  // namespace silisizer
@@ -0,0 +1,149 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+#include "Metrics.h"
+
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
+#include "ResourceUsage.h"
+
+namespace silisizer {
+
+const char *phaseName(Phase phase) {
+  switch (phase) {
+    case Phase::find_paths:
+      return "find_paths";
+    case Phase::score:
+      return "score";
+    case Phase::rank:
+      return "rank";
+    case Phase::resize:
+      return "resize";
+    case Phase::output:
+      return "output";
+  }
+  return "unknown";
+}
+
+MetricsRecorder::MetricsRecorder() : run_start_(wallSeconds()) {}
+
+void MetricsRecorder::beginIteration(int iter) {
+  iterations_.emplace_back();
+  iterations_.back().iter = iter;
+  iteration_open_ = true;
+}
+
+void MetricsRecorder::endIteration() {
+  if (!iteration_open_) return;
+  iteration_open_ = false;
+  current().rss_bytes = currentRssBytes();
+  current().elapsed = wallSeconds() - run_start_;
+}
+
+MetricsRecorder::Scope::Scope(MetricsRecorder *metrics, Phase phase)
+    : metrics_(metrics),
+      phase_(phase),
+      wall_start_(wallSeconds()),
+      cpu_start_(cpuSeconds()) {}
+
+MetricsRecorder::Scope::~Scope() {
+  if (!metrics_ || metrics_->empty()) return;
+  double wall = wallSeconds() - wall_start_;
+  IterationMetrics &iteration = metrics_->current();
+  PhaseTime &time = iteration.phases[(int) phase_];
+  time.wall += wall;
+  time.cpu += cpuSeconds() - cpu_start_;
+  if (!metrics_->trace_path_.empty())
+    metrics_->trace_events_.push_back(
+        {phase_, iteration.iter, wall_start_ - metrics_->run_start_, wall});
+}
+
+bool MetricsRecorder::write(const std::string &json_path) const {
+  bool ok = writeJson(json_path);
+  if (!trace_path_.empty()) ok &= writeTrace(trace_path_);
+  return ok;
+}
+
+static void writePhases(std::ofstream &out, const PhaseTime *phases) {
+  out << "{";
+  for (int phase = 0; phase < PHASE_COUNT; phase++) {
+    out << (phase ? ", " : "") << "\"" << phaseName((Phase) phase)
+        << "\": {\"wall\": " << phases[phase].wall
+        << ", \"cpu\": " << phases[phase].cpu << "}";
+  }
+  out << "}";
+}
+
+bool MetricsRecorder::writeJson(const std::string &path) const {
+  std::ofstream out(path);
+  if (!out.good()) return false;
+  out << std::setprecision(std::numeric_limits<double>::max_digits10);
+
+  PhaseTime totals[PHASE_COUNT];
+  out << "{\n  \"iterations\": [";
+  for (size_t i = 0; i < iterations_.size(); i++) {
+    const IterationMetrics &it = iterations_[i];
+    out << (i ? "," : "") << "\n    {\"iter\": " << it.iter
+        << ", \"wns\": " << it.wns
+        << ", \"violating_endpoints\": " << it.violating_endpoints
+        << ", \"path_pins\": " << it.path_pins
+        << ", \"offenders\": " << it.offenders << ", \"swaps\": " << it.swaps
+        << ", \"rss_bytes\": " << it.rss_bytes
+        << ", \"elapsed\": " << it.elapsed << ",\n     \"phases\": ";
+    writePhases(out, it.phases);
+    out << "}";
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+      totals[phase].wall += it.phases[phase].wall;
+      totals[phase].cpu += it.phases[phase].cpu;
+    }
+  }
+  out << (iterations_.empty() ? "" : "\n  ") << "],\n  \"totals\": ";
+  writePhases(out, totals);
+  out << ",\n  \"wall\": " << wallSeconds() - run_start_
+      << ",\n  \"peak_rss_bytes\": " << peakRssBytes() << "\n}\n";
+  out.close();
+  return !out.fail();
+}
+
+// Chrome trace-event format: one complete ("X") event per phase and a
+// counter ("C") track for RSS and WNS, timestamps in microseconds
+bool MetricsRecorder::writeTrace(const std::string &path) const {
+  std::ofstream out(path);
+  if (!out.good()) return false;
+  out << std::fixed << std::setprecision(3);
+  out << "{\"traceEvents\": [";
+  bool first = true;
+  for (const TraceEvent &event : trace_events_) {
+    out << (first ? "" : ",") << "\n  {\"name\": \"" << phaseName(event.phase)
+        << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, \"ts\": "
+        << event.start * 1e6 << ", \"dur\": " << event.wall * 1e6
+        << ", \"args\": {\"iter\": " << event.iter << "}}";
+    first = false;
+  }
+  for (const IterationMetrics &it : iterations_) {
+    out << (first ? "" : ",")
+        << "\n  {\"name\": \"silisize\", \"ph\": \"C\", \"pid\": 1, \"ts\": "
+        << it.elapsed * 1e6 << ", \"args\": {\"rss_mb\": " << it.rss_bytes / 1e6
+        << ", \"wns_ps\": " << -(it.wns * 1e12) << "}}";
+    first = false;
+  }
+  out << "\n]}\n";
+  out.close();
+  return !out.fail();
+}
+
+}  // namespace silisizer
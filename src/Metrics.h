@@ -0,0 +1,108 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace silisizer {
+
+// Stages of one sizing iteration
+enum class Phase {
+  find_paths,  // timer query for violating endpoints
+  score,       // critical path backtrace and offender scoring
+  rank,        // offender queue update and batch selection
+  resize,      // replaceCell on every folded copy
+  output,      // resized_cells.tsv and journal writes
+};
+const int PHASE_COUNT = 5;
+
+const char *phaseName(Phase phase);
+
+struct PhaseTime {
+  double wall = 0.0;
+  double cpu = 0.0;
+};
+
+struct IterationMetrics {
+  int iter = 0;
+  double wns = 0.0;
+  PhaseTime phases[PHASE_COUNT];
+  size_t violating_endpoints = 0;
+  size_t path_pins = 0;
+  size_t offenders = 0;
+  size_t swaps = 0;
+  size_t rss_bytes = 0;
+  // Seconds since the run started, at the end of the iteration
+  double elapsed = 0.0;
+};
+
+// Per-iteration wall/CPU time of every phase plus work counters, exported as
+// JSON and optionally as a Chrome trace-event file (chrome://tracing,
+// Perfetto).
+class MetricsRecorder {
+ public:
+  MetricsRecorder();
+
+  void beginIteration(int iter);
+  // Counters of the iteration in progress
+  IterationMetrics &current() { return iterations_.back(); }
+  bool empty() const { return iterations_.empty(); }
+
+  // Times a phase from construction to destruction and adds it to the
+  // iteration in progress
+  class Scope {
+   public:
+    Scope(MetricsRecorder *metrics, Phase phase);
+    ~Scope();
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+   private:
+    MetricsRecorder *metrics_;
+    Phase phase_;
+    double wall_start_;
+    double cpu_start_;
+  };
+
+  // Stamp the end time and current RSS on the iteration in progress (once)
+  void endIteration();
+  // Record trace events for `trace_path` as well ("" disables tracing)
+  void setTracePath(const std::string &trace_path) { trace_path_ = trace_path; }
+  // Rewrite the JSON (and trace) files with everything recorded so far, so a
+  // killed run still leaves its metrics behind. Returns false on failure.
+  bool write(const std::string &json_path) const;
+
+ private:
+  struct TraceEvent {
+    Phase phase;
+    int iter;
+    double start;
+    double wall;
+  };
+  bool writeJson(const std::string &path) const;
+  bool writeTrace(const std::string &path) const;
+
+  double run_start_;
+  bool iteration_open_ = false;
+  std::vector<IterationMetrics> iterations_;
+  std::string trace_path_;
+  std::vector<TraceEvent> trace_events_;
+};
+
+}  // namespace silisizer
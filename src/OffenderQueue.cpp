@@ -0,0 +1,109 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+#include "OffenderQueue.h"
+
+#include <algorithm>
+
+namespace silisizer {
+
+void OffenderQueue::sync(const OffenderScores &scores) {
+  last_update_count_ = 0;
+
+  // Drop instances that left every violating path (fixed or resized)
+  std::vector<sta::Instance *> stale;
+  for (const Offender &offender : heap_)
+    if (scores.find(offender.first) == scores.end())
+      stale.push_back(offender.first);
+  for (sta::Instance *inst : stale) removeAt(index_[inst]);
+  last_update_count_ += stale.size();
+
+  for (const auto &[inst, score] : scores) {
+    auto it = index_.find(inst);
+    if (it == index_.end()) {
+      push({inst, score});
+      last_update_count_++;
+    } else {
+      const OffenderScore &old = heap_[it->second].second;
+      if (old.score != score.score || old.first_seen != score.first_seen) {
+        update(it->second, score);
+        last_update_count_++;
+      }
+    }
+  }
+}
+
+std::vector<Offender> OffenderQueue::popTop(size_t count) {
+  std::vector<Offender> top;
+  top.reserve(std::min(count, heap_.size()));
+  while (top.size() < count && !heap_.empty()) {
+    top.push_back(heap_.front());
+    removeAt(0);
+  }
+  return top;
+}
+
+void OffenderQueue::push(const Offender &offender) {
+  index_[offender.first] = heap_.size();
+  heap_.push_back(offender);
+  siftUp(heap_.size() - 1);
+}
+
+void OffenderQueue::removeAt(size_t pos) {
+  size_t last = heap_.size() - 1;
+  if (pos != last) swapEntries(pos, last);
+  index_.erase(heap_.back().first);
+  heap_.pop_back();
+  if (pos < heap_.size()) {
+    siftUp(pos);
+    siftDown(pos);
+  }
+}
+
+void OffenderQueue::update(size_t pos, const OffenderScore &score) {
+  heap_[pos].second = score;
+  siftUp(pos);
+  siftDown(pos);
+}
+
+void OffenderQueue::siftUp(size_t pos) {
+  while (pos > 0) {
+    size_t parent = (pos - 1) / 2;
+    if (!before(heap_[pos], heap_[parent])) break;
+    swapEntries(pos, parent);
+    pos = parent;
+  }
+}
+
+void OffenderQueue::siftDown(size_t pos) {
+  for (;;) {
+    size_t best = pos;
+    size_t left = 2 * pos + 1;
+    size_t right = left + 1;
+    if (left < heap_.size() && before(heap_[left], heap_[best])) best = left;
+    if (right < heap_.size() && before(heap_[right], heap_[best])) best = right;
+    if (best == pos) break;
+    swapEntries(pos, best);
+    pos = best;
+  }
+}
+
+void OffenderQueue::swapEntries(size_t a, size_t b) {
+  std::swap(heap_[a], heap_[b]);
+  index_[heap_[a].first] = a;
+  index_[heap_[b].first] = b;
+}
+
+}  // namespace silisizer
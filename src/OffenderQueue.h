@@ -0,0 +1,67 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "OffenderScore.h"
+
+namespace silisizer {
+
+typedef std::pair<sta::Instance *, OffenderScore> Offender;
+
+// Indexed max-heap of offenders kept across sizing iterations. The scores
+// are still rebuilt from the paths every pass and sync() compares all of
+// them with the queue, but only entries whose score moved are sifted, and a
+// batch pops just its top entries instead of sorting the whole table.
+class OffenderQueue {
+ public:
+  // Bring the queue in line with this pass's scores: moved entries are
+  // re-keyed in place, vanished ones dropped and new ones pushed. Looks up
+  // every queued and every scored instance once.
+  void sync(const OffenderScores &scores);
+  // Remove and return up to `count` offenders, best first
+  std::vector<Offender> popTop(size_t count);
+
+  bool empty() const { return heap_.empty(); }
+  size_t size() const { return heap_.size(); }
+  // Entries whose score changed during the last sync
+  size_t lastUpdateCount() const { return last_update_count_; }
+
+ private:
+  // Higher score first; ties go to the instance seen first on the paths
+  static bool before(const Offender &a, const Offender &b) {
+    if (a.second.score != b.second.score)
+      return a.second.score > b.second.score;
+    return a.second.first_seen < b.second.first_seen;
+  }
+  void push(const Offender &offender);
+  void removeAt(size_t pos);
+  void update(size_t pos, const OffenderScore &score);
+  void siftUp(size_t pos);
+  void siftDown(size_t pos);
+  void swapEntries(size_t a, size_t b);
+
+  std::vector<Offender> heap_;
+  std::unordered_map<sta::Instance *, size_t> index_;
+  size_t last_update_count_ = 0;
+};
+
+}  // namespace silisizer
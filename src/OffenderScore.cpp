@@ -0,0 +1,161 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+#include "OffenderScore.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "Parallel.h"
+
+namespace silisizer {
+
+namespace {
+
+// One path step routed to the shard that owns its instance
+struct ShardStep {
+  sta::Instance *inst;
+  double delta_score;
+  size_t seen;
+};
+
+}  // namespace
+
+OffenderScores scorePaths(const std::vector<EndpointPath> &paths,
+                          int thread_count) {
+  size_t step_count = 0;
+  for (const EndpointPath &path : paths) step_count += path.steps.size();
+  int shard_count = usefulThreads(thread_count, step_count);
+
+  // Map instances found in all paths, record cumulative arc delay gain for
+  // each instance accross all paths
+  auto score = [](OffenderScores &scores, sta::Instance *inst,
+                  double delta_score, size_t seen) {
+    auto [it, inserted] = scores.try_emplace(inst);
+    if (inserted) it->second.first_seen = seen;
+    it->second.score += delta_score;
+  };
+  if (shard_count == 1) {
+    OffenderScores scores;
+    size_t seen = 0;
+    for (const EndpointPath &path : paths)
+      for (const PathStep &step : path.steps)
+        score(scores, step.inst, std::min((double) step.gain, -path.slack),
+              seen++);
+    return scores;
+  }
+
+  // Each thread routes the steps of a contiguous run of paths to the shards
+  // that own their instances, then each shard adds up its own steps, run by
+  // run. Every step is read once, and every shard still sees its steps in
+  // path order.
+  std::vector<size_t> first_seen(shard_count);
+  for (int thread = 1; thread < shard_count; thread++) {
+    auto [begin, end] = threadChunk(thread - 1, shard_count, paths.size());
+    first_seen[thread] = first_seen[thread - 1];
+    for (size_t i = begin; i < end; i++)
+      first_seen[thread] += paths[i].steps.size();
+  }
+  std::vector<std::vector<std::vector<ShardStep>>> routed(
+      shard_count, std::vector<std::vector<ShardStep>>(shard_count));
+  runThreads(shard_count, [&](int thread) {
+    auto [begin, end] = threadChunk(thread, shard_count, paths.size());
+    size_t seen = first_seen[thread];
+    for (size_t i = begin; i < end; i++) {
+      const EndpointPath &path = paths[i];
+      for (const PathStep &step : path.steps)
+        routed[thread][pointerShard(step.inst, shard_count)].push_back(
+            {step.inst, std::min((double) step.gain, -path.slack), seen++});
+    }
+  });
+
+  std::vector<OffenderScores> shards(shard_count);
+  runThreads(shard_count, [&](int shard) {
+    for (int thread = 0; thread < shard_count; thread++)
+      for (const ShardStep &step : routed[thread][shard])
+        score(shards[shard], step.inst, step.delta_score, step.seen);
+  });
+
+  // Shards own disjoint instances, so merging only moves entries
+  OffenderScores scores = std::move(shards[0]);
+  for (int shard = 1; shard < shard_count; shard++)
+    scores.merge(shards[shard]);
+  return scores;
+}
+
+OffenderScores scoreScenes(
+    const std::vector<const std::vector<EndpointPath> *> &scene_paths,
+    const std::vector<double> &weights, int thread_count) {
+  size_t scene_count = scene_paths.size();
+  if (scene_count == 1 && weights[0] == 1.0)
+    return scorePaths(*scene_paths[0], thread_count);
+
+  // Split the threads between the scenes; each scene shards its own table
+  int worker_count = (int) std::min<size_t>(scene_count, thread_count);
+  int scene_threads = std::max(1, thread_count / worker_count);
+  std::vector<OffenderScores> scene_scores(scene_count);
+  runThreads(worker_count, [&](int worker) {
+    for (size_t s = worker; s < scene_count; s += worker_count)
+      scene_scores[s] = scorePaths(*scene_paths[s], scene_threads);
+  });
+
+  std::vector<size_t> scene_steps(scene_count, 0);
+  for (size_t s = 0; s < scene_count; s++)
+    for (const EndpointPath &path : *scene_paths[s])
+      scene_steps[s] += path.steps.size();
+  return mergeSceneScores(scene_scores, scene_steps, weights);
+}
+
+OffenderScores mergeSceneScores(const std::vector<OffenderScores> &scene_scores,
+                                const std::vector<size_t> &scene_steps,
+                                const std::vector<double> &weights) {
+  // Offset first_seen by the steps of the earlier scenes so ties stay in
+  // scene order
+  OffenderScores scores;
+  size_t offset = 0;
+  for (size_t s = 0; s < scene_scores.size(); s++) {
+    for (const auto &[inst, scene_score] : scene_scores[s]) {
+      auto [it, inserted] = scores.try_emplace(inst);
+      if (inserted) it->second.first_seen = offset + scene_score.first_seen;
+      it->second.score += weights[s] * scene_score.score;
+    }
+    offset += scene_steps[s];
+  }
+  return scores;
+}
+
+OffenderScores foldScores(const OffenderScores &scores,
+                          const FoldIndex &folds) {
+  std::vector<std::pair<sta::Instance *, OffenderScore>> ordered(
+      scores.begin(), scores.end());
+  std::sort(ordered.begin(), ordered.end(),
+            [](const auto &a, const auto &b) {
+              return a.second.first_seen < b.second.first_seen;
+            });
+
+  OffenderScores folded;
+  std::unordered_map<int, sta::Instance *> representative;
+  for (const auto &[inst, score] : ordered) {
+    int fold = folds.find(inst);
+    if (fold < 0) continue;
+    auto [rep, first] = representative.try_emplace(fold, inst);
+    OffenderScore &total = folded[rep->second];
+    if (first) total.first_seen = score.first_seen;
+    total.score += score.score;
+  }
+  return folded;
+}
+
+}  // namespace silisizer
@@ -0,0 +1,66 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "EndpointCache.h"
+#include "FoldIndex.h"
+
+namespace silisizer {
+
+// Cumulative arc delay gain of one instance across all violating paths
+struct OffenderScore {
+  double score = 0.0;
+  // Position of the first path step that reached this instance. Ties in score
+  // are broken by it, so the ranking never depends on hashing or threads.
+  size_t first_seen = 0;
+};
+
+typedef std::unordered_map<sta::Instance *, OffenderScore> OffenderScores;
+
+// Score every resizable instance on `paths`. The steps are routed to shards
+// by instance across up to `thread_count` threads, each reading its own run
+// of paths; each shard still adds its instances' contributions in path
+// order, so the result is bit-identical to a single threaded run.
+OffenderScores scorePaths(const std::vector<EndpointPath> &paths,
+                          int thread_count);
+
+// Score the violating paths of each scene on its own threads and merge the
+// tables, scaling each scene's contribution by its weight. Ties keep the
+// order of first appearance, scene by scene.
+OffenderScores scoreScenes(
+    const std::vector<const std::vector<EndpointPath> *> &scene_paths,
+    const std::vector<double> &weights, int thread_count);
+
+// Merge tables already scored per scene, scaling each by its weight.
+// `scene_steps` holds the path step count of each scene, by which first_seen
+// is offset so ties keep the order of first appearance, scene by scene.
+OffenderScores mergeSceneScores(const std::vector<OffenderScores> &scene_scores,
+                                const std::vector<size_t> &scene_steps,
+                                const std::vector<double> &weights);
+
+// Merge the scores of folded copies into one entry per (module, cell) group,
+// keyed by the copy seen first, since a resize swaps every copy at once.
+// Copies are added in first_seen order, so the sums do not depend on hashing.
+// Instances outside the fold index are dropped.
+OffenderScores foldScores(const OffenderScores &scores,
+                          const FoldIndex &folds);
+
+}  // namespace silisizer
@@ -0,0 +1,94 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace silisizer {
+
+// Below this many work items per thread, spawning threads costs more than it
+// saves.
+const size_t MIN_ITEMS_PER_THREAD = 256;
+
+// Number of threads worth using for `items` work items with at most
+// `max_threads` available
+inline int usefulThreads(int max_threads, size_t items) {
+  size_t useful = items / MIN_ITEMS_PER_THREAD;
+  return (int) std::max<size_t>(1, std::min<size_t>(max_threads, useful));
+}
+
+// Run fn(thread) for every thread in [0, thread_count); thread 0 runs on the
+// caller. Returns once all of them are done.
+template <typename Fn>
+void runThreads(int thread_count, Fn fn) {
+  std::vector<std::thread> workers;
+  for (int t = 1; t < thread_count; t++) workers.emplace_back(fn, t);
+  fn(0);
+  for (std::thread &worker : workers) worker.join();
+}
+
+// Contiguous [begin, end) slice of `count` items handled by `thread`
+inline std::pair<size_t, size_t> threadChunk(int thread, int thread_count,
+                                             size_t count) {
+  size_t begin = count * thread / thread_count;
+  size_t end = count * (thread + 1) / thread_count;
+  return {begin, end};
+}
+
+// Thread that owns `ptr` when a table keyed by pointers is sharded. The low
+// bits of heap pointers are alignment zeros, so mix before reducing.
+inline int pointerShard(const void *ptr, int shard_count) {
+  uint64_t key = reinterpret_cast<uintptr_t>(ptr);
+  key = (key >> 4) * 0x9E3779B97F4A7C15ull;
+  return (int) ((key >> 32) % (uint64_t) shard_count);
+}
+
+#ifdef __linux__
+
+// Write all of `data` to the pipe `fd` of a forked worker
+inline bool writeAll(int fd, const char *data, size_t size) {
+  while (size > 0) {
+    ssize_t written = write(fd, data, size);
+    if (written <= 0) return false;
+    data += written;
+    size -= written;
+  }
+  return true;
+}
+
+// Read the pipe `fd` of a forked worker to its end into `received`
+inline bool readAll(int fd, std::string &received) {
+  char buffer[1 << 16];
+  ssize_t got;
+  while ((got = read(fd, buffer, sizeof(buffer))) > 0)
+    received.append(buffer, got);
+  return got == 0;
+}
+
+#endif
+
+}  // namespace silisizer
@@ -0,0 +1,33 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+
+namespace silisizer {
+
+// Peak resident set size of this process so far, in bytes
+size_t peakRssBytes();
+// Current resident set size of this process, in bytes (the peak where the
+// platform does not report it)
+size_t currentRssBytes();
+// User plus system CPU time of this process (all threads), in seconds
+double cpuSeconds();
+// Wall-clock time from a fixed monotonic origin, in seconds
+double wallSeconds();
+
+}  // namespace silisizer
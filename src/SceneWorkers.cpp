@@ -0,0 +1,192 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+#include "SceneWorkers.h"
+
+#ifdef __linux__
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <utility>
+
+#include "Parallel.h"
+
+namespace silisizer {
+
+#ifdef __linux__
+
+// Fixed-size values on the worker pipes, in the layout of this process
+template <typename T>
+static void pack(std::string &bytes, const T &value) {
+  bytes.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T>
+static bool unpack(const std::string &bytes, size_t &pos, T &value) {
+  if (bytes.size() - pos < sizeof(T)) return false;
+  std::memcpy(&value, bytes.data() + pos, sizeof(T));
+  pos += sizeof(T);
+  return true;
+}
+
+// Refresh and score one scene in the worker process
+static std::string refreshScene(EndpointCache &cache, bool full_retime,
+                                const std::vector<sta::Instance *> &changed) {
+  if (full_retime)
+    cache.refreshAll();
+  else
+    cache.refreshFanout(changed);
+  OffenderScores scores = scorePaths(cache.paths(), 1);
+
+  std::string bytes;
+  pack(bytes, cache.groupCount());
+  pack(bytes, cache.lastRefreshCount());
+  pack(bytes, cache.paths().size());
+  for (const EndpointPath &path : cache.paths()) {
+    pack(bytes, path.vertex);
+    pack(bytes, path.slack);
+    pack(bytes, path.clock);
+    pack(bytes, path.steps.size());
+    bytes.append(reinterpret_cast<const char *>(path.steps.data()),
+                 path.steps.size() * sizeof(PathStep));
+  }
+  pack(bytes, scores.size());
+  for (const auto &[inst, score] : scores) {
+    pack(bytes, inst);
+    pack(bytes, score);
+  }
+  return bytes;
+}
+
+// A scene sent back by its worker
+struct SceneResult {
+  int group_count;
+  size_t refresh_count;
+  std::vector<EndpointPath> paths;
+  OffenderScores scores;
+};
+
+static bool unpackScene(const std::string &bytes, SceneResult &result) {
+  size_t pos = 0;
+  size_t path_count;
+  if (!unpack(bytes, pos, result.group_count) ||
+      !unpack(bytes, pos, result.refresh_count) ||
+      !unpack(bytes, pos, path_count))
+    return false;
+  for (size_t i = 0; i < path_count; i++) {
+    EndpointPath path;
+    size_t step_count;
+    if (!unpack(bytes, pos, path.vertex) || !unpack(bytes, pos, path.slack) ||
+        !unpack(bytes, pos, path.clock) || !unpack(bytes, pos, step_count))
+      return false;
+    path.steps.resize(step_count);
+    for (PathStep &step : path.steps)
+      if (!unpack(bytes, pos, step)) return false;
+    result.paths.push_back(std::move(path));
+  }
+  size_t score_count;
+  if (!unpack(bytes, pos, score_count)) return false;
+  for (size_t i = 0; i < score_count; i++) {
+    sta::Instance *inst;
+    OffenderScore score;
+    if (!unpack(bytes, pos, inst) || !unpack(bytes, pos, score)) return false;
+    result.scores.emplace(inst, score);
+  }
+  return pos == bytes.size();
+}
+
+bool refreshScenes(Silisizer *sizer,
+                   std::vector<std::unique_ptr<EndpointCache>> &caches,
+                   bool full_retime,
+                   const std::vector<sta::Instance *> &changed,
+                   std::vector<OffenderScores> &scene_scores, Logger &log) {
+  // Arrivals are shared by every scene's query, so they are propagated once
+  // on all threads before the workers copy them. Workers then inherit only
+  // the forking thread, as for speculation.
+  sizer->updateTiming(false);
+  int thread_count = sizer->threadCount();
+  sizer->setThreadCount(1);
+  log.flush();
+  std::cout.flush();
+  std::cerr.flush();
+
+  struct Worker {
+    pid_t pid;
+    int fd;
+  };
+  std::vector<Worker> workers;
+  for (std::unique_ptr<EndpointCache> &cache : caches) {
+    int fds[2];
+    if (pipe(fds) != 0) break;
+    pid_t pid = fork();
+    if (pid < 0) {
+      close(fds[0]);
+      close(fds[1]);
+      break;
+    }
+    if (pid == 0) {
+      close(fds[0]);
+      std::string bytes = refreshScene(*cache, full_retime, changed);
+      _exit(writeAll(fds[1], bytes.data(), bytes.size()) ? 0 : 1);
+    }
+    close(fds[1]);
+    workers.push_back({pid, fds[0]});
+  }
+
+  // Each worker only ever blocks on its own pipe, so draining them one at a
+  // time cannot deadlock. Nothing is adopted unless every scene came back.
+  std::vector<SceneResult> results(workers.size());
+  bool complete = workers.size() == caches.size();
+  for (size_t s = 0; s < workers.size(); s++) {
+    std::string received;
+    bool received_all = readAll(workers[s].fd, received);
+    close(workers[s].fd);
+    int status;
+    waitpid(workers[s].pid, &status, 0);
+    if (!received_all || !WIFEXITED(status) || WEXITSTATUS(status) != 0 ||
+        !unpackScene(received, results[s]))
+      complete = false;
+  }
+  sizer->setThreadCount(thread_count);
+  if (!complete) {
+    log(LogLevel::quiet) << "WARNING: a scene worker failed, re-timing the "
+                            "scenes one at a time";
+    return false;
+  }
+
+  scene_scores.clear();
+  for (size_t s = 0; s < caches.size(); s++) {
+    caches[s]->adopt(std::move(results[s].paths), results[s].group_count,
+                     results[s].refresh_count);
+    scene_scores.push_back(std::move(results[s].scores));
+  }
+  return true;
+}
+
+#else
+
+bool refreshScenes(Silisizer *, std::vector<std::unique_ptr<EndpointCache>> &,
+                   bool, const std::vector<sta::Instance *> &,
+                   std::vector<OffenderScores> &, Logger &) {
+  return false;
+}
+
+#endif
+
+}  // namespace silisizer
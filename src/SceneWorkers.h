@@ -0,0 +1,44 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "EndpointCache.h"
+#include "Logger.h"
+#include "OffenderScore.h"
+#include "Silisizer.h"
+
+namespace silisizer {
+
+// Refresh each of `caches`, one per scene, in its own forked worker and score
+// its paths there, so a timing pass over several scenes costs about as much
+// as the slowest scene. The parent propagates arrivals once beforehand, so a
+// worker only queries and backtraces its own scene; each sends back its
+// refreshed cache and score table, which replace the parent's cache and fill
+// `scene_scores`. Without `full_retime` only the fanout endpoints of
+// `changed` are re-timed, as in EndpointCache::refreshFanout. Returns false
+// when forking is unavailable (non-Linux) or a worker failed, leaving the
+// caller to refresh the scenes one at a time.
+bool refreshScenes(Silisizer *sizer,
+                   std::vector<std::unique_ptr<EndpointCache>> &caches,
+                   bool full_retime,
+                   const std::vector<sta::Instance *> &changed,
+                   std::vector<OffenderScores> &scene_scores, Logger &log);
+
+}  // namespace silisizer
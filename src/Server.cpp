@@ -0,0 +1,227 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+#include "Server.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace silisizer {
+
+#ifdef __linux__
+
+// Read the request script until the client shuts down its write side.
+// Returns false if the connection fails, goes idle for REQUEST_TIMEOUT_SECONDS
+// or the script is too large.
+static bool readRequest(int fd, std::string &request) {
+  timeval timeout = {REQUEST_TIMEOUT_SECONDS, 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  char buffer[1 << 16];
+  ssize_t got;
+  while ((got = read(fd, buffer, sizeof(buffer))) > 0) {
+    request.append(buffer, got);
+    if (request.size() > MAX_REQUEST_BYTES) return false;
+  }
+  return got == 0;
+}
+
+static void writeAll(int fd, const std::string &text) {
+  const char *data = text.data();
+  size_t size = text.size();
+  while (size > 0) {
+    ssize_t written = write(fd, data, size);
+    if (written <= 0) return;
+    data += written;
+    size -= written;
+  }
+}
+
+// Evaluate `request` in the forked child with its output on `fd`
+static void runRequest(Tcl_Interp *interp, sta::Sta *sta, int thread_count,
+                       int fd, const std::string &request) {
+  dup2(fd, STDOUT_FILENO);
+  dup2(fd, STDERR_FILENO);
+  // The parent's STA worker threads do not exist in the fork; start fresh
+  sta->setThreadCount(thread_count);
+  int status = Tcl_Eval(interp, request.c_str());
+  std::string result = Tcl_GetStringResult(interp);
+
+  Tcl_Channel out = Tcl_GetStdChannel(TCL_STDOUT);
+  if (out) Tcl_Flush(out);
+  std::cout.flush();
+  std::cerr.flush();
+  std::fflush(stdout);
+  std::fflush(stderr);
+  writeAll(fd, (status == TCL_OK ? "OK " : "ERROR ") + result + '\n');
+}
+
+// Read and run the request of connection `fd` in the forked child
+static void handleConnection(Tcl_Interp *interp, sta::Sta *sta,
+                             int thread_count, int fd) {
+  std::string request;
+  if (!readRequest(fd, request)) {
+    writeAll(fd, "ERROR request unreadable, idle or larger than " +
+                     std::to_string(MAX_REQUEST_BYTES) + " bytes\n");
+    return;
+  }
+  size_t first = request.find_first_not_of(" \t\r\n");
+  if (first == std::string::npos) {
+    writeAll(fd, "ERROR empty request\n");
+    return;
+  }
+  size_t last = request.find_last_not_of(" \t\r\n");
+  if (request.compare(first, last - first + 1, "shutdown") == 0) {
+    writeAll(fd, "OK shutdown\n");
+    kill(getppid(), SIGUSR1);
+    return;
+  }
+  runRequest(interp, sta, thread_count, fd, request);
+}
+
+static volatile std::sig_atomic_t shutdown_requested = 0;
+// Self-pipe written by the shutdown handler, so a shutdown that arrives
+// just before the accept loop waits still wakes it
+static int shutdown_pipe[2] = {-1, -1};
+
+static void requestShutdown(int) {
+  shutdown_requested = 1;
+  char byte = 0;
+  ssize_t written = write(shutdown_pipe[1], &byte, 1);
+  (void) written;
+}
+
+// Collect finished requests; with `block`, wait for all of them
+static void reapRequests(bool block) {
+  while (waitpid(-1, nullptr, block ? 0 : WNOHANG) > 0) {
+  }
+}
+
+int serveRequests(Tcl_Interp *interp, sta::Sta *sta, const char *path) {
+  sockaddr_un address = {};
+  address.sun_family = AF_UNIX;
+  if (std::strlen(path) >= sizeof(address.sun_path)) {
+    std::cerr << "silisizer: socket path too long: " << path << std::endl;
+    return 1;
+  }
+  std::strcpy(address.sun_path, path);
+
+  // Requests run arbitrary Tcl, so only the owner may connect. The socket
+  // is created with owner-only permissions rather than restricted after
+  // bind(), which would leave it open to others in between.
+  int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+  unlink(path);
+  mode_t mask = umask(0077);
+  bool bound = listener >= 0 &&
+               bind(listener, (sockaddr *) &address, sizeof(address)) == 0;
+  umask(mask);
+  if (!bound || listen(listener, 16) != 0 ||
+      fcntl(listener, F_SETFL, O_NONBLOCK) != 0 || pipe(shutdown_pipe) != 0 ||
+      fcntl(shutdown_pipe[1], F_SETFL, O_NONBLOCK) != 0) {
+    std::cerr << "silisizer: cannot listen on " << path << ": "
+              << std::strerror(errno) << std::endl;
+    if (listener >= 0) close(listener);
+    if (bound) unlink(path);
+    return 1;
+  }
+  // A client that disconnects before its reply must not kill the server
+  std::signal(SIGPIPE, SIG_IGN);
+
+  // Forks inherit only the forking thread, so the STA worker threads are
+  // stopped while serving and each request starts its own
+  int thread_count = sta->threadCount();
+  sta->setThreadCount(1);
+  std::cout << "Serving sizing requests on " << path << std::endl;
+
+  // A child that receives "shutdown" signals the server, which wakes the
+  // poll() below through the self-pipe
+  struct sigaction stop = {};
+  stop.sa_handler = requestShutdown;
+  sigaction(SIGUSR1, &stop, nullptr);
+
+  while (!shutdown_requested) {
+    pollfd waiting[2] = {{listener, POLLIN, 0}, {shutdown_pipe[0], POLLIN, 0}};
+    int ready = poll(waiting, 2, -1);
+    reapRequests(false);
+    if (ready < 0 && errno != EINTR) {
+      std::cerr << "silisizer: poll failed: " << std::strerror(errno)
+                << std::endl;
+      break;
+    }
+    if (ready <= 0 || !(waiting[0].revents & POLLIN)) continue;
+    int fd = accept(listener, nullptr, nullptr);
+    if (fd < 0) {
+      // The client may have gone between poll() and accept()
+      if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK ||
+          errno == ECONNABORTED)
+        continue;
+      std::cerr << "silisizer: accept failed: " << std::strerror(errno)
+                << std::endl;
+      break;
+    }
+
+    // The request is read in the child, so a slow or idle client never
+    // holds up the accept loop
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(stdout);
+    std::fflush(stderr);
+    pid_t pid = fork();
+    if (pid == 0) {
+      close(listener);
+      close(shutdown_pipe[0]);
+      close(shutdown_pipe[1]);
+      handleConnection(interp, sta, thread_count, fd);
+      _exit(0);
+    }
+    if (pid < 0)
+      writeAll(fd, std::string("ERROR fork failed: ") + std::strerror(errno) +
+                       '\n');
+    close(fd);
+  }
+
+  close(listener);
+  close(shutdown_pipe[0]);
+  close(shutdown_pipe[1]);
+  unlink(path);
+  reapRequests(true);
+  sta->setThreadCount(thread_count);
+  return 0;
+}
+
+#else
+
+int serveRequests(Tcl_Interp *, sta::Sta *, const char *) {
+  std::cerr << "silisizer: -server is only supported on Linux" << std::endl;
+  return 1;
+}
+
+#endif
+
+}  // namespace silisizer
@@ -0,0 +1,45 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+
+#include <tcl.h>
+
+#include "sta/Sta.hh"
+
+namespace silisizer {
+
+// Largest request script accepted, in bytes
+const size_t MAX_REQUEST_BYTES = 1 << 20;
+// Longest a client may stay silent while sending its request
+const int REQUEST_TIMEOUT_SECONDS = 10;
+
+// Serve sizing requests on the Unix socket at `path` with the design already
+// loaded in `interp`. A request is a Tcl script (for example constraint
+// changes followed by sta::silisize) sent by the client, which then shuts
+// down its write side. Each request runs in its own copy-on-write fork of
+// this process, so the loaded design is never modified and requests run
+// side by side. The socket is private to the owner, and a client that stalls
+// while sending its request is dropped after REQUEST_TIMEOUT_SECONDS. The
+// child's output is streamed back over the connection, followed by a last
+// line "OK <result>" or "ERROR <message>". The request "shutdown" stops the
+// server once running requests have finished. Returns the process exit
+// status (Linux only; elsewhere it reports an error).
+int serveRequests(Tcl_Interp *interp, sta::Sta *sta, const char *path);
+
+}  // namespace silisizer
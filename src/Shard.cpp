@@ -0,0 +1,202 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+#include "Shard.h"
+
+#ifdef __linux__
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "BatchController.h"
+#include "OffenderQueue.h"
+#include "OffenderScore.h"
+#include "Parallel.h"
+#include "Speculation.h"
+
+namespace silisizer {
+
+std::vector<std::vector<sta::Vertex *>> shardEndpoints(
+    const std::vector<EndpointPath> &violating, int shard_count) {
+  // Clock domains in order of first appearance
+  std::vector<std::vector<sta::Vertex *>> domains;
+  std::unordered_map<const sta::Clock *, size_t> domain_index;
+  for (const EndpointPath &path : violating) {
+    auto [it, inserted] = domain_index.try_emplace(path.clock, domains.size());
+    if (inserted) domains.emplace_back();
+    domains[it->second].push_back(path.vertex);
+  }
+
+  std::vector<std::vector<sta::Vertex *>> shards(shard_count);
+  if (domains.size() >= (size_t) shard_count) {
+    std::stable_sort(domains.begin(), domains.end(),
+                     [](const auto &a, const auto &b) {
+                       return a.size() > b.size();
+                     });
+    for (std::vector<sta::Vertex *> &domain : domains) {
+      auto lightest = std::min_element(
+          shards.begin(), shards.end(),
+          [](const auto &a, const auto &b) { return a.size() < b.size(); });
+      lightest->insert(lightest->end(), domain.begin(), domain.end());
+    }
+  } else {
+    for (size_t i = 0; i < violating.size(); i++)
+      shards[i % shard_count].push_back(violating[i].vertex);
+  }
+  shards.erase(std::remove_if(shards.begin(), shards.end(),
+                              [](const auto &shard) { return shard.empty(); }),
+               shards.end());
+  return shards;
+}
+
+#ifdef __linux__
+
+// Size one shard in the worker process, in batches sized by `policy` as in
+// the main loop. Returns the groups it moved and how many grades, in the
+// order they were first swapped.
+static std::vector<ShardProposal> sizeShard(
+    Silisizer *sizer, EndpointCache &cache, const FoldIndex &folds,
+    const SpeedLadder &ladder, const std::vector<sta::Vertex *> &endpoints,
+    BatchPolicy policy) {
+  std::vector<ShardProposal> proposals;
+  std::unordered_map<int, size_t> proposal_index;
+  OffenderQueue queue;
+  std::unique_ptr<BatchController> controller = makeBatchController(policy);
+  int batch = 1;
+  BatchFeedback feedback;
+  for (int iter = 0; iter < MAX_SHARD_ITERS; iter++) {
+    cache.refreshEndpoints(endpoints);
+    if (cache.paths().empty()) break;
+    double wns = 0.0;
+    double tns = 0.0;
+    for (const EndpointPath &path : cache.paths()) {
+      wns = std::min(wns, path.slack);
+      tns += path.slack;
+    }
+    feedback.wns_after = wns;
+    feedback.tns_after = tns;
+    if (iter > 0) batch = controller->nextSize(batch, feedback);
+
+    queue.sync(foldScores(scorePaths(cache.paths(), 1), folds));
+    std::vector<Offender> offenders = queue.popTop(batch);
+    std::vector<int> swapped;
+    std::vector<CellSwap> swaps =
+        foldSwaps(sizer->network(), folds, ladder, offenders,
+                  offenders.size(), &swapped);
+    if (swaps.empty()) break;
+    for (const CellSwap &swap : swaps)
+      sizer->replaceCell(swap.inst, swap.to);
+    for (int fold : swapped) {
+      auto [it, inserted] = proposal_index.try_emplace(fold, proposals.size());
+      if (inserted) proposals.push_back({fold, 0});
+      proposals[it->second].grades++;
+    }
+    feedback = {offenders.size(), wns, wns, tns, tns};
+  }
+  return proposals;
+}
+
+std::vector<ShardProposal> proposeShardSwaps(
+    Silisizer *sizer, EndpointCache &cache, const FoldIndex &folds,
+    const SpeedLadder &ladder,
+    const std::vector<std::vector<sta::Vertex *>> &shards, BatchPolicy policy,
+    Logger &log) {
+  // Workers inherit only the forking thread and must not touch the log
+  // writer, so both are quiesced first, as for speculation
+  int thread_count = sizer->threadCount();
+  sizer->setThreadCount(1);
+  log.flush();
+  std::cout.flush();
+  std::cerr.flush();
+
+  struct Worker {
+    size_t shard;
+    pid_t pid;
+    int fd;
+  };
+  std::vector<Worker> workers;
+  for (size_t shard = 0; shard < shards.size(); shard++) {
+    int fds[2];
+    if (pipe(fds) != 0) break;
+    pid_t pid = fork();
+    if (pid < 0) {
+      close(fds[0]);
+      close(fds[1]);
+      break;
+    }
+    if (pid == 0) {
+      close(fds[0]);
+      std::vector<ShardProposal> proposals =
+          sizeShard(sizer, cache, folds, ladder, shards[shard], policy);
+      bool sent = writeAll(fds[1], (const char *) proposals.data(),
+                           proposals.size() * sizeof(ShardProposal));
+      _exit(sent ? 0 : 1);
+    }
+    close(fds[1]);
+    workers.push_back({shard, pid, fds[0]});
+  }
+
+  // Each worker only ever blocks on its own pipe, so draining them one at a
+  // time cannot deadlock
+  std::map<int, int> merged;
+  for (const Worker &worker : workers) {
+    std::string received;
+    bool complete = readAll(worker.fd, received);
+    close(worker.fd);
+    int status;
+    waitpid(worker.pid, &status, 0);
+    if (!complete || !WIFEXITED(status) || WEXITSTATUS(status) != 0 ||
+        received.size() % sizeof(ShardProposal) != 0) {
+      log(LogLevel::quiet) << "WARNING: shard " << worker.shard
+                           << " worker failed, its endpoints are left to "
+                              "the global passes";
+      continue;
+    }
+    size_t count = received.size() / sizeof(ShardProposal);
+    const ShardProposal *proposals =
+        reinterpret_cast<const ShardProposal *>(received.data());
+    for (size_t i = 0; i < count; i++) {
+      int &grades = merged[proposals[i].fold];
+      grades = std::max(grades, proposals[i].grades);
+    }
+    log(LogLevel::normal) << "Shard " << worker.shard << ": "
+                          << shards[worker.shard].size() << " endpoints, "
+                          << count << " cells proposed";
+  }
+
+  sizer->setThreadCount(thread_count);
+  std::vector<ShardProposal> result;
+  for (const auto &[fold, grades] : merged) result.push_back({fold, grades});
+  return result;
+}
+
+#else
+
+std::vector<ShardProposal> proposeShardSwaps(
+    Silisizer *, EndpointCache &, const FoldIndex &, const SpeedLadder &,
+    const std::vector<std::vector<sta::Vertex *>> &, BatchPolicy, Logger &) {
+  return {};
+}
+
+#endif
+
+}  // namespace silisizer
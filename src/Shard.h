@@ -0,0 +1,61 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <vector>
+
+#include "BatchController.h"
+#include "EndpointCache.h"
+#include "FoldIndex.h"
+#include "Logger.h"
+#include "Silisizer.h"
+#include "SpeedLadder.h"
+
+namespace silisizer {
+
+// Most batches one shard worker sizes before reporting back
+const int MAX_SHARD_ITERS = 64;
+
+// A (module, cell) group and how many speed grades to move it up
+struct ShardProposal {
+  int fold;
+  int grades;
+};
+
+// Split the endpoints of `violating` into up to `shard_count` non-empty
+// shards. With at least as many capturing clocks as shards, each clock
+// domain goes whole to the least loaded shard, largest first; otherwise the
+// endpoints are dealt round-robin so every shard gets a share of the worst
+// ones.
+std::vector<std::vector<sta::Vertex *>> shardEndpoints(
+    const std::vector<EndpointPath> &violating, int shard_count);
+
+// Fork one copy-on-write worker per shard. Each re-times only its own
+// endpoints through `cache` and upsizes the offenders of its shard in batches
+// sized by `policy` until they stop violating, then reports the fold groups
+// it moved over a pipe and exits; the parent's design is never touched.
+// Proposals are merged by taking the most grades any worker asked for, since
+// one upsize serves every shard whose paths go through the cell. Returns the
+// merged proposals in fold order, or none when forking is unavailable
+// (non-Linux).
+std::vector<ShardProposal> proposeShardSwaps(
+    Silisizer *sizer, EndpointCache &cache, const FoldIndex &folds,
+    const SpeedLadder &ladder,
+    const std::vector<std::vector<sta::Vertex *>> &shards, BatchPolicy policy,
+    Logger &log);
+
+}  // namespace silisizer
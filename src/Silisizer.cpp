@@ -17,249 +17,524 @@
 
 #include <algorithm>
 #include <cmath>
+#include <condition_variable>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
-#include <list>
 #include <memory>
-#include <set>
+#include <mutex>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "BatchController.h"
+#include "BatchSelector.h"
+#include "DelayGain.h"
+#include "EndpointCache.h"
+#include "FoldIndex.h"
+#include "GraphCriticality.h"
+#include "Journal.h"
+#include "JsonWriter.h"
+#include "OffenderQueue.h"
+#include "OffenderScore.h"
+#include "Parallel.h"
+#include "ResourceUsage.h"
+#include "SceneWorkers.h"
+#include "Shard.h"
+#include "Speculation.h"
+#include "SpeedLadder.h"
+#include "TransformWriter.h"
 #include "sta/Liberty.hh"
 #include "sta/Network.hh"
-#include "sta/PathEnd.hh"
 #include "sta/PortDirection.hh"
+#include "sta/Scene.hh"
 #include "sta/Sta.hh"
 #include "sta/TimingRole.hh"
 
 namespace silisizer {
 
-// DEBUG flag
-const bool DEBUG = 0;
-
 // Number of consecutive non-improving timing passes allowed by the WNS policy.
 const int WNS_STALL_ROUND_LIMIT = 3;
 
-// Replace all occurrences of `from` in `str` with `to`
-std::string replaceAll(std::string_view str, std::string_view from,
-                       std::string_view to) {
-  size_t start_pos = 0;
-  std::string result(str);
-  while ((start_pos = result.find(from, start_pos)) != std::string::npos) {
-    result.replace(start_pos, from.length(), to);
-    start_pos += to.length(); // handles case where 'to' is a substr of 'from'
+// Bulk-apply the swaps of journaled batches through the fold index. A group
+// journaled k times climbs k speed grades, and every leaf is replaced once.
+// Returns the number of journaled resizes found in the design.
+static size_t replayJournal(Silisizer *sizer,
+                            const std::vector<JournalBatch> &batches,
+                            const FoldIndex &folds, const SpeedLadder &ladder,
+                            TransformWriter &transforms, Logger &log) {
+  sta::Network *network = sizer->network();
+  std::vector<int> grades(folds.groupCount(), 0);
+  size_t replayed = 0;
+  for (const JournalBatch &batch : batches) {
+    for (const auto &[module, cell] : batch.swaps) {
+      int fold = folds.find(module, cell);
+      if (fold < 0) {
+        log(LogLevel::quiet) << "WARNING: Journaled cell " << module << " "
+                             << cell << " is not resizable in this design";
+        continue;
+      }
+      grades[fold]++;
+      replayed++;
+      transforms.add(module, cell);
+    }
+  }
+
+  std::vector<CellSwap> swaps;
+  for (size_t fold = 0; fold < grades.size(); fold++) {
+    if (!grades[fold]) continue;
+    for (sta::Instance *leaf : folds.leaves(fold)) {
+      sta::LibertyCell *from = network->libertyCell(network->cell(leaf));
+      sta::LibertyCell *to = from;
+      for (int grade = 0; to && grade < grades[fold]; grade++) {
+        sta::LibertyCell *next = ladder.faster(to);
+        if (!next) break;
+        to = next;
+      }
+      if (to != from) swaps.push_back({leaf, to});
+    }
   }
-  return result;
+  for (const CellSwap &swap : swaps) sizer->replaceCell(swap.inst, swap.to);
+  transforms.flushBatch();
+  return replayed;
 }
 
-// Reverse the internal naming convention used by OpenSTA for readback
-std::string reverseOpenSTANaming(std::string cellname) {
-  cellname = replaceAll(cellname, "\\[", "[");
-  cellname = replaceAll(cellname, "\\]", "]");
-  cellname = replaceAll(cellname, "\\/", "/");
-  cellname = replaceAll(cellname, "\\\\", "\\");
-  return cellname;
+OffenderScores Silisizer::offenderScores(bool graph_scoring) {
+  Logger log(LogLevel::quiet);
+  SpeedLadder ladder(network(), log);
+  DelayGainTable gains(ladder);
+  if (graph_scoring) return scoreGraph(this, &ladder, &gains, nullptr).scores;
+  EndpointCache endpoints(this, &ladder, &gains, scenes(), nullptr);
+  endpoints.refreshAll();
+  return scorePaths(endpoints.paths(), threadCount());
 }
 
 // Silisizer: resize operator-level cells to resolve timing violations
 int Silisizer::silisize(const char *workdir,
-                        bool upsize_all,
-                        bool stop_on_wns_stall) {
+                        const SilisizeOptions &options) {
+  // Start of the -max_time budget
+  double run_start = wallSeconds();
+
   // Initialize network
   sta::Network* network = this->network();
 
   // Effort variables (multiply swaps per iteration by 2 until complete)
   int swaps_per_iter = 1;
 
-  // Record of (module, cell) pairs that have already been upsized.
-  std::set<std::pair<std::string, std::string>> recorded;
-
-  // Populate map of sp0 leaf copies by (module, cell) for fast lookups
-  // {
-  //   (module1, cell1) -> [leaf instances]
-  //   (module1, cell2) -> [leaf instances]
-  //   (module2, cell1) -> [leaf instances]
-  //   (module2, cell2) -> [leaf instances]
-  //   ...
-  // }
-  std::unordered_map<std::string, std::vector<sta::Instance*>> fold_insts;
-  {
-    std::unique_ptr<sta::LeafInstanceIterator> leaves(
-        network->leafInstanceIterator());
-    while (leaves->hasNext()) { // loop over all leaves
-      sta::Instance* leaf = leaves->next();
-      sta::Instance* parent = network->parent(leaf);
-      if (!parent)
-        continue;
-      sta::LibertyCell* leaf_lib = network->libertyCell(network->cell(leaf));
-      if (!leaf_lib ||
-          std::string(leaf_lib->name()).find("_sp0_") == std::string::npos)
-        continue;
-      // Construct key for future lookup
-      std::string key = std::string(network->cellName(parent)) + '\t' +
-                        reverseOpenSTANaming(network->name(leaf));
-      // Add leaf instance to list for the cell
-      fold_insts[key].push_back(leaf);
+  // Console output, written in blocks by a background thread
+  Logger log(options.log_level);
+
+  // Every weighted scene has to exist
+  for (const auto &[name, weight] : options.scene_weights) {
+    bool found = false;
+    for (sta::Scene *scene : scenes()) found |= name == scene->name();
+    if (!found) {
+      log.error() << "silisize: no scene named " << name;
+      return 1;
     }
   }
 
+  // Index the speed ladders of all loaded libraries once
+  SpeedLadder ladder(network, log);
+  // Rate every arc of a resizable cell against its faster model once
+  DelayGainTable gains(ladder);
+
+  // Index resizable leaf copies by (module, cell) for fast lookups
+  FoldIndex folds(network, ladder);
+  log(LogLevel::normal) << "Fold index: " << folds.groupCount() << " cells, "
+                        << folds.leafCount() << " copies, "
+                        << folds.nameCount() << " names in "
+                        << folds.buildSeconds() << " s, "
+                        << folds.bytes() / (1 << 20) << " MB (peak RSS "
+                        << peakRssBytes() / (1 << 20) << " MB)";
+
+  // Hierarchy prefixes of the offenders named in the resize log
+  HierarchyPrefixes prefixes(network);
+
+  // Batch in which each fold group was last upsized. Every folded copy is
+  // swapped together, so each group climbs one speed grade per batch.
+  std::vector<int> recorded_iter(folds.groupCount(), -1);
+
   // Output the header for back-annotation TSV. Preqorsor always reads this
   // file after SPEED==2 STA, so failing to create it must be a hard error.
   std::string workdir_str = workdir;
   std::string data_dir = workdir_str + "/data";
-  std::string transforms_path = data_dir + "/resized_cells.tsv";
+  std::string transforms_path =
+      data_dir + (options.compress_transforms ? "/resized_cells.tsv.gz"
+                                              : "/resized_cells.tsv");
   std::error_code ec;
   std::filesystem::create_directories(data_dir, ec);
   if (ec) {
-    std::cerr << "silisize: cannot create " << data_dir << ": " << ec.message()
-              << std::endl;
+    log.error() << "silisize: cannot create " << data_dir << ": "
+                << ec.message();
     return 1;
   }
-  std::ofstream transforms(transforms_path);
-  if (!transforms.good()) {
-    std::cerr << "silisize: cannot open " << transforms_path << " for write"
-              << std::endl;
+  TransformWriter transforms;
+  if (!transforms.open(transforms_path, options.compress_transforms)) {
+    log.error() << "silisize: cannot open " << transforms_path
+                << " for write";
     return 1;
   }
-  transforms << "Scope" << "\t" << "Instance" << std::endl;
-
-  // Flush/close the transforms file and surface any write failure (disk full,
-  // NFS stale handle, flush error) as a hard error, so Preqorsor never
-  // back-annotates a truncated resized_cells.tsv.
-  auto close_transforms = [&transforms, &transforms_path]() -> int {
-    transforms.close();
-    if (transforms.fail()) {
-      std::cerr << "silisize: failed writing " << transforms_path << std::endl;
-      return 1;
-    }
-    return 0;
-  };
 
-  // Iterate until the maximum number of iterations is reached
+  // Journal every batch so that a killed run can pick up where it stopped
+  std::string journal_path = data_dir + "/silisize_journal.tsv";
+  std::vector<JournalBatch> resumed;
+  if (options.resume && !ResizeJournal::read(journal_path, resumed))
+    log(LogLevel::quiet) << "No journal to resume from at " << journal_path;
+  ResizeJournal journal;
+  if (!journal.open(journal_path, resumed))
+    log.error() << "silisize: cannot open " << journal_path
+                << " for write, resume journal disabled";
+
+  // Iteration state, restored from the last journaled batch when resuming.
+  // The journal keeps no TNS, so the first batch after a resume is sized
+  // without feedback like the first batch of a fresh run.
+  int start_iter = 0;
   double previous_wns = 1;
+  double previous_tns = 0.0;
+  size_t previous_swaps = 0;
   int wns_stall_rounds = 0;
-  for (int cur_iter = 0; true; cur_iter++) {
-    // Run timer to get violating paths (one per endpoint)
-    std::cout << "Running timer..." << std::endl;
-
-    sta::StringSeq group_names;  // empty = report all path groups
-
-    sta::PathEndSeq ends = sta_->findPathEnds(
-        /*exception from*/ nullptr, /*exception through*/ nullptr,
-        /*exception to*/ nullptr, /*unconstrained*/ false, /*scenes*/ sta_->scenes(),
-        /*min_max*/ sta::MinMaxAll::max(),
-        /*group_count*/ 10000, /*endpoint_count*/ 1,
-        /*unique_pins*/ true,
-        /*unique_edges*/ true,
-        /*min_slack*/ -1.0e+30, /*max_slack*/ 0.0,
-        /*sort_by_slack*/ false,
-        /*groups->size() ? groups :*/ group_names,
-        /*setup*/ true, /*hold*/ false,
-        /*recovery*/ false, /*removal*/ false,
-        /*clk_gating_setup*/ false, /*clk_gating_hold*/ false);
-
-    // If no paths are found, we are done
-    if (ends.empty()) {
-      std::cout << "No paths found..." << std::endl
-                << "Final WNS: 0" << std::endl
-                << "Timing optimization done!" << std::endl;
-      break;
-    }
+  if (!resumed.empty()) {
+    const JournalBatch &last = resumed.back();
+    start_iter = last.iter + 1;
+    swaps_per_iter = last.next_swaps_per_iter;
+    wns_stall_rounds = last.wns_stall_rounds;
+    previous_wns = last.wns;
+    size_t replayed =
+        replayJournal(this, resumed, folds, ladder, transforms, log);
+    log(LogLevel::normal) << "Resumed " << resumed.size() << " batches ("
+                          << replayed << " resizes) from " << journal_path;
+  }
 
-    // DEBUG: Print the number of paths found
-    if (DEBUG)
-      std::cout << "Violating path count: " << ends.size() << std::endl;
+  // Per-phase timing and counters, rewritten after every iteration
+  MetricsRecorder metrics;
+  metrics.setTracePath(options.trace_path);
+  std::string metrics_path = data_dir + "/silisize_metrics.json";
+  auto finish = [&]() -> int {
+    metrics.endIteration();
+    if (!metrics.write(metrics_path))
+      log.error() << "silisize: failed writing " << metrics_path;
+    return transforms.close(log);
+  };
 
-    // Initialize variables
-    std::unordered_map<sta::Instance*, double> offending_inst_score;
+  // Violating endpoints, re-timed in full or only around the last batch. In
+  // per-scene mode every scene has its own cache and weight.
+  std::vector<std::unique_ptr<EndpointCache>> scene_endpoints;
+  std::vector<double> scene_weights;
+  if (options.per_scene) {
+    for (sta::Scene *scene : scenes()) {
+      scene_endpoints.push_back(std::make_unique<EndpointCache>(
+          this, &ladder, &gains, sta::SceneSeq{scene}, &metrics));
+      auto weight = options.scene_weights.find(scene->name());
+      scene_weights.push_back(
+          weight == options.scene_weights.end() ? 1.0 : weight->second);
+    }
+  } else {
+    scene_endpoints.push_back(
+        std::make_unique<EndpointCache>(this, &ladder, &gains, scenes(),
+                                        &metrics));
+    scene_weights.push_back(1.0);
+  }
+  for (auto& endpoints : scene_endpoints) {
+    endpoints->setStreaming(options.stream_paths);
+    endpoints->setMemoryBudget((size_t) options.memory_budget_mb << 20);
+  }
+  std::vector<sta::Instance*> last_swapped;
+
+  // Offender ranking, kept across iterations and updated in place
+  OffenderQueue queue;
+  std::unique_ptr<BatchController> batch_controller =
+      makeBatchController(options.batch_policy);
+  // Violating paths through each offender, for path-disjoint batches
+  PathMembership membership;
+
+  // Sharded presizing: one worker process per shard of the violating
+  // endpoints proposes swaps for its shard alone. The merged proposals are
+  // applied here one grade per batch, and the loop below then times the
+  // whole design and fixes whatever the shards left.
+  if (options.shards > 1 && resumed.empty()) {
+    metrics.beginIteration(start_iter);
+    EndpointCache all(this, &ladder, &gains, scenes(), &metrics);
+    all.setMemoryBudget((size_t) options.memory_budget_mb << 20);
+    all.refreshAll();
     double wns = 0.0;
+    double tns = 0.0;
+    for (const EndpointPath& path : all.paths()) {
+      wns = std::min(wns, path.slack);
+      tns += path.slack;
+    }
+    std::vector<ShardProposal> proposals;
+    {
+      MetricsRecorder::Scope timing(&metrics, Phase::resize);
+      proposals = proposeShardSwaps(
+          this, all, folds, ladder,
+          shardEndpoints(all.paths(), options.shards), options.batch_policy,
+          log);
+    }
+    int rounds = 0;
+    for (const ShardProposal& proposal : proposals)
+      rounds = std::max(rounds, proposal.grades);
+    // Every merged round is checked against the whole design before it is
+    // committed: the shards never saw each other's swaps, so a round that
+    // makes global WNS or TNS worse is undone and presizing stops there
+    sta::Slack round_wns;
+    sta::Vertex* worst_vertex;
+    worstSlack(sta::MinMax::max(), round_wns, worst_vertex);
+    double accepted_wns = std::min(0.0, (double) round_wns);
+    double accepted_tns = totalNegativeSlack(sta::MinMax::max());
+    int applied = 0;
+    size_t presized = 0;
+    for (; applied < rounds; applied++) {
+      JournalBatch batch;
+      batch.iter = start_iter + applied;
+      batch.wns = accepted_wns;
+      batch.next_swaps_per_iter = swaps_per_iter;
+      std::vector<Offender> offenders;
+      for (const ShardProposal& proposal : proposals)
+        if (proposal.grades > applied)
+          offenders.emplace_back(*folds.leaves(proposal.fold).begin(),
+                                 OffenderScore());
+      std::vector<int> swapped;
+      std::vector<CellSwap> swaps;
+      std::vector<CellSwap> undo;
+      {
+        MetricsRecorder::Scope timing(&metrics, Phase::resize);
+        swaps = foldSwaps(network, folds, ladder, offenders, offenders.size(),
+                          &swapped);
+        for (int fold : swapped) {
+          sta::Instance* leaf = *folds.leaves(fold).begin();
+          sta::LibertyCell* from = network->libertyCell(network->cell(leaf));
+          if (!from || !ladder.faster(from)) continue;
+          log(LogLevel::normal)
+              << "Resizing instance " << prefixes.prefix(leaf)
+              << folds.cellName(fold) << " of type " << from->name()
+              << " to type " << ladder.faster(from)->name();
+        }
+        for (const CellSwap& swap : swaps) {
+          undo.push_back(
+              {swap.inst, network->libertyCell(network->cell(swap.inst))});
+          replaceCell(swap.inst, swap.to);
+        }
+      }
+      if (swaps.empty()) break;
 
-    // For each path with negative slack
-    for (sta::PathEnd* pathend : ends) {
-      // Get path
-      sta::Path* path = pathend->path();
-
-      // DEBUG: Print the endpoint
-      if (DEBUG)
-        std::cout << "Violation endpoint: " << network->name(path->pin(this))
-                  << std::endl;
-      
-      // Get the path slack
-      double slack = pathend->slack(this);
-      if (slack >= 0.0) continue;
-
-      // Record the path with the worst negative slack (WNS)
-      if (slack < wns) {
-        wns = slack;
+      double tns_after;
+      {
+        MetricsRecorder::Scope timing(&metrics, Phase::find_paths);
+        worstSlack(sta::MinMax::max(), round_wns, worst_vertex);
+        tns_after = totalNegativeSlack(sta::MinMax::max());
+      }
+      double wns_after = std::min(0.0, (double) round_wns);
+      if (wns_after < accepted_wns || tns_after < accepted_tns) {
+        for (const CellSwap& swap : undo) replaceCell(swap.inst, swap.to);
+        log(LogLevel::normal)
+            << "Sharded presizing: round " << applied + 1
+            << " made WNS or TNS worse, undone";
+        break;
+      }
+      accepted_wns = wns_after;
+      accepted_tns = tns_after;
+      presized += swapped.size();
+
+      for (int fold : swapped) {
+        transforms.add(folds.moduleName(fold), folds.cellName(fold));
+        batch.swaps.emplace_back(folds.moduleName(fold),
+                                 folds.cellName(fold));
       }
+      metrics.current().swaps += swaps.size();
+      MetricsRecorder::Scope timing(&metrics, Phase::output);
+      if (!transforms.flushBatch()) return finish();
+      journal.append(batch, log);
+    }
+    log(LogLevel::normal) << "Sharded presizing: " << presized
+                          << " cells in " << applied << " batches";
+    metrics.current().wns = wns;
+    metrics.current().violating_endpoints = all.paths().size();
+    metrics.endIteration();
+    start_iter += std::max(applied, 1);
+    // The first global pass measures the gain of the presize batches
+    if (wns < 0.0) {
+      previous_wns = wns;
+      previous_tns = tns;
+      previous_swaps = presized;
+    }
+  }
 
-      // Follow the path backwards to populate offending instance count
-      for (sta::Path* p = path; p && !p->isNull(); p = p->prevPath()) {
-        // Get the pin
-        sta::Pin *pin = p->pin(this);
-        // Get previous arc
-        sta::TimingArc* prev_arc = p->prevArc(this);
-        // Past a transparent latch the path is in a different launch cycle
-        if (prev_arc && prev_arc->role()->isLatchDtoQ()) break;
-        // Get the arc delay
-        sta::Delay delay = 0.0f;
-        if (prev_arc) delay = prev_arc->intrinsicDelay();
-        // Get the instance and cell
-        sta::Instance* inst = network->instance(pin);
-        sta::Cell* cell = network->cell(inst);
-        // If the instance does not have a cell, skip
-        if (!cell) continue;
-        // If cell is not a Liberty cell, skip
-        sta::LibertyCell* libcell = network->libertyCell(cell);
-        if (!libcell) continue;
-        // If cell is not speed 0, skip
-        std::string libcellname = libcell->name();
-        if (libcellname.find("_sp0_") == std::string::npos) {
-          if (DEBUG) std::cout << "Speed 1 cell: " << libcellname << std::endl;
-          continue;
+  // Iterate until the maximum number of iterations is reached
+  for (int cur_iter = start_iter; true; cur_iter++) {
+    metrics.beginIteration(cur_iter);
+
+    // Run timer to get violating paths (one per endpoint)
+    log(LogLevel::normal) << "Running timer...";
+
+    double wns = 0.0;
+    double tns = 0.0;
+    size_t violating_count = 0;
+    OffenderScores offending_inst_score;
+    if (options.graph_scoring) {
+      // One pass over the timing graph scores every violating endpoint
+      GraphCriticality graph = scoreGraph(this, &ladder, &gains, &metrics);
+      wns = graph.wns;
+      tns = graph.tns;
+      violating_count = graph.violating_endpoints;
+      offending_inst_score = std::move(graph.scores);
+    } else {
+      // The periodic full pass guards against anything the fanout cones of
+      // the swapped cells did not capture.
+      bool full_retime = !options.incremental || last_swapped.empty() ||
+                         cur_iter % options.full_retime_interval == 0;
+      // Several scenes are timed side by side in forked workers, which also
+      // score them; otherwise, or if a worker fails, one after the other
+      std::vector<OffenderScores> scene_scores;
+      auto refresh = [&](bool full) {
+        if (scene_endpoints.size() > 1) {
+          MetricsRecorder::Scope timing(&metrics, Phase::find_paths);
+          if (refreshScenes(this, scene_endpoints, full, last_swapped,
+                            scene_scores, log))
+            return;
         }
-        // Map instances found in all paths, record cumulative arc delay
-        // contribution for each instance accross all paths
-        double delta_score = std::min((double) delay, -slack);
-        if (offending_inst_score.find(inst) == offending_inst_score.end()) {
-          offending_inst_score.emplace(inst, delta_score);
-        } else {
-          offending_inst_score.find(inst)->second += delta_score;
+        scene_scores.clear();
+        for (auto& endpoints : scene_endpoints) {
+          if (full)
+            endpoints->refreshAll();
+          else
+            endpoints->refreshFanout(last_swapped);
         }
+      };
+      std::vector<int> group_counts;
+      for (auto& endpoints : scene_endpoints)
+        group_counts.push_back(endpoints->groupCount());
+      refresh(full_retime);
+      bool offenders_found = false;
+      for (size_t s = 0; s < scene_endpoints.size(); s++) {
+        int group_count = scene_endpoints[s]->groupCount();
+        if (group_count != group_counts[s])
+          log(LogLevel::normal)
+              << "Memory budget: RSS " << currentRssBytes() / (1 << 20)
+              << " MB, "
+              << (group_count < group_counts[s] ? "lowering" : "raising")
+              << " group count to " << group_count;
+        offenders_found |= scene_endpoints[s]->hasOffenders();
       }
+      // Never conclude the run from a partial view of the design
+      if (!full_retime && !offenders_found) {
+        log(LogLevel::normal) << "Confirming with full timer run...";
+        refresh(true);
+      }
+
+      // An endpoint violating in several scenes counts once, at its worst
+      // slack, so TNS and the endpoint count match a single multi-scene run
+      std::unordered_map<sta::Vertex*, double> endpoint_slack;
+      std::vector<const std::vector<EndpointPath>*> scene_paths;
+      std::vector<size_t> scene_steps;
+      for (auto& endpoints : scene_endpoints) {
+        const std::vector<EndpointPath>& paths = endpoints->paths();
+        scene_paths.push_back(&paths);
+        scene_steps.push_back(0);
+
+        // Print the number of re-timed endpoints
+        if (!full_retime)
+          log(LogLevel::verbose)
+              << "Re-timed endpoints: " << endpoints->lastRefreshCount();
+
+        // Record the path with the worst negative slack (WNS) and the
+        // total negative slack (TNS)
+        for (const EndpointPath& path : paths) {
+          scene_steps.back() += path.steps.size();
+          if (path.slack < wns) {
+            wns = path.slack;
+          }
+          auto [it, inserted] =
+              endpoint_slack.try_emplace(path.vertex, path.slack);
+          if (inserted) {
+            tns += path.slack;
+          } else if (path.slack < it->second) {
+            tns += path.slack - it->second;
+            it->second = path.slack;
+          }
+        }
+      }
+      violating_count = endpoint_slack.size();
+
+      // Score the instances on all violating paths across the STA threads,
+      // unless the scene workers already did
+      MetricsRecorder::Scope timing(&metrics, Phase::score);
+      if (scene_scores.empty())
+        offending_inst_score =
+            scoreScenes(scene_paths, scene_weights, threadCount());
+      else
+        offending_inst_score =
+            mergeSceneScores(scene_scores, scene_steps, scene_weights);
+      if (options.disjoint_batches) membership.build(scene_paths);
+    }
+    last_swapped.clear();
+
+    // Rank (module, cell) groups, so every batch slot is a distinct ECO
+    {
+      MetricsRecorder::Scope timing(&metrics, Phase::score);
+      offending_inst_score = foldScores(offending_inst_score, folds);
+    }
+
+    // If no paths are found, we are done
+    if (violating_count == 0) {
+      log(LogLevel::quiet) << "No paths found...\n"
+                           << "Final WNS: 0\n"
+                           << "Timing optimization done!";
+      break;
     }
 
+    // Print the number of paths found
+    log(LogLevel::verbose) << "Violating path count: " << violating_count;
+
+    metrics.current().wns = wns;
+    metrics.current().violating_endpoints = violating_count;
+    metrics.current().offenders = offending_inst_score.size();
+
     // Set previous WNS to current if not initialized (-1)
     if (previous_wns > 0) previous_wns = wns;
 
-    // DEBUG: Print the number of offending instances
-    if (DEBUG)
-      std::cout << "offending_inst_score: " << offending_inst_score.size()
-                << std::endl;
+    // Budgets are checked right after timing so the report reflects every
+    // batch applied so far
+    int run_iters = cur_iter - start_iter;
+    double run_seconds = wallSeconds() - run_start;
+    bool out_of_iters = options.max_iters > 0 && run_iters >= options.max_iters;
+    bool out_of_time =
+        options.max_time > 0.0 && run_seconds >= options.max_time;
+    if (out_of_iters || out_of_time) {
+      log(LogLevel::quiet) << (out_of_iters ? "Iteration" : "Time")
+                           << " budget reached after " << run_iters
+                           << " iterations in " << run_seconds << " s.\n"
+                           << "Final WNS: " << -(wns * 1e12) << '\n'
+                           << "Timing optimization stopped at budget!";
+      break;
+    }
+
+    // Print the number of offending instances
+    log(LogLevel::verbose) << "offending_inst_score: "
+                           << offending_inst_score.size();
 
     // Check if there is nothing left to do
     if (offending_inst_score.empty()) {
       // If there are no fixable cells at all and the WNS is zero, we are done
       if (wns == 0.0f) {
-        std::cout << "No fixable cells and WNS is 0!" << std::endl
-                  << "Final WNS: 0" << std::endl
-                  << "Timing optimization done!" << std::endl;
+        log(LogLevel::quiet) << "No fixable cells and WNS is 0!\n"
+                             << "Final WNS: 0\n"
+                             << "Timing optimization done!";
       }
       // If there are no fixable cells at all and the WNS is non-zero, then we
       // have done all we can, but we are still failing timing
       else {
-        std::cout << "No fixable cells and WNS is non-zero!" << std::endl
-                  << "Final WNS: " << -(wns * 1e12) << std::endl
-                  << "Timing optimization partially done!" << std::endl;
+        log(LogLevel::quiet) << "No fixable cells and WNS is non-zero!\n"
+                             << "Final WNS: " << -(wns * 1e12) << '\n'
+                             << "Timing optimization partially done!";
       }
       break;
     }
 
     // The WNS policy intentionally stops even while other violating paths may
     // still benefit from resizing.
-    if (stop_on_wns_stall && cur_iter > 0) {
+    if (options.stop_on_wns_stall && cur_iter > 0) {
       double delta_wns = wns - previous_wns;
       if (delta_wns <= 0.0)
         wns_stall_rounds++;
@@ -267,97 +542,118 @@ int Silisizer::silisize(const char *workdir,
         wns_stall_rounds = 0;
 
       if (wns_stall_rounds >= WNS_STALL_ROUND_LIMIT) {
-        std::cout << "WNS did not improve for " << wns_stall_rounds
-                  << " consecutive rounds." << std::endl
-                  << "Final WNS: " << -(wns * 1e12) << std::endl
-                  << "WNS optimization done!" << std::endl;
+        log(LogLevel::quiet) << "WNS did not improve for " << wns_stall_rounds
+                             << " consecutive rounds.\n"
+                             << "Final WNS: " << -(wns * 1e12) << '\n'
+                             << "WNS optimization done!";
         break;
       }
     }
 
-    // Sort the offender list and, unless requested otherwise, limit it to the
-    // adaptive number of swaps for this iteration.
-    std::list<std::pair<sta::Instance*, double>> offenders;
-    for (const auto& pair : offending_inst_score)
-      offenders.push_back(pair);
-    offenders.sort([](const std::pair<sta::Instance*, double>& a,
-                      const std::pair<sta::Instance*, double>& b) {
-      return a.second > b.second;
-    });
-    if (!upsize_all)
-      offenders.resize(std::min(swaps_per_iter, (int) offenders.size()));
-
-    // DEBUG: Print the number of offenders
-    if (DEBUG) std::cout << "offenders: " << offenders.size() << std::endl;
+    // Re-key the persistent offender queue and, unless requested otherwise,
+    // take only the adaptive number of swaps for this iteration.
+    std::vector<Offender> offenders;
+    {
+      MetricsRecorder::Scope timing(&metrics, Phase::rank);
+      queue.sync(offending_inst_score);
+      if (options.upsize_all) {
+        offenders = queue.popTop(queue.size());
+      } else if (options.speculate > 1) {
+        // Time candidate batch sizes in forked children and keep the one
+        // with the best WNS gain per swap. Popped entries that go unused
+        // come back with the next sync.
+        std::vector<size_t> sizes = speculativeSizes(
+            swaps_per_iter, options.speculate, queue.size());
+        offenders = queue.popTop(sizes.empty() ? swaps_per_iter
+                                               : sizes.back());
+        if (sizes.size() > 1) {
+          // Without a WNS gain from any child the base size stays
+          size_t best = speculateBatchSize(this, folds, ladder, offenders,
+                                           sizes, wns, log);
+          if (best) swaps_per_iter = (int) best;
+          log(LogLevel::normal)
+              << "Speculation adopted batch of " << swaps_per_iter;
+        }
+        if (offenders.size() > (size_t) swaps_per_iter)
+          offenders.resize(swaps_per_iter);
+      } else if (options.disjoint_batches && !options.graph_scoring) {
+        offenders = popDisjoint(queue, swaps_per_iter, membership, folds);
+      } else {
+        offenders = queue.popTop(swaps_per_iter);
+      }
+    }
+
+    // Print the number of offenders
+    log(LogLevel::verbose) << "offenders: " << offenders.size();
 
     // If no offending cells, we are done
     if (offenders.empty()) {
-      std::cout << "No offenders found..." << std::endl
-                << "Final WNS: 0" << std::endl
-                << "Timing optimization done!" << std::endl;
+      log(LogLevel::quiet) << "No offenders found...\n"
+                           << "Final WNS: 0\n"
+                           << "Timing optimization done!";
       break;
     }
 
-    // For each offending cell, resize to speed 1
-    for (auto offender_pair : offenders) {
-      // Get the instance, cell, library, and Liberty cell
-      sta::Instance* offender = offender_pair.first;
-      sta::Cell* cell = network->cell(offender);
-      sta::LibertyLibrary* library = network->libertyLibrary(offender);
-      sta::LibertyCell* libcell = network->libertyCell(cell);
-      // Get speed 0 and 1 cell names
-      std::string sp0_name = libcell->name();
-      std::string sp1_name = replaceAll(sp0_name, "_sp0_", "_sp1_");
-      // Get hierarchical parent module name
-      std::string fullname;
-      sta::Instance* parent = network->parent(offender);
-      std::string parentcellname = network->cellName(parent);
-      for (; parent; parent = network->parent(parent)) {
-        std::string parentName = network->name(parent);
-        if (!parentName.empty()) fullname += parentName + ".";
-      }
-      std::string cellname = reverseOpenSTANaming(network->name(offender));
-
-      // Insert key into recorded set
-      std::pair<std::string, std::string> key{parentcellname, cellname};
-      if (recorded.find(key) != recorded.end())
-        continue; // skip if already recorded, as we swap all instances already
-      // A sibling in this batch may already have closed the fold to sp1.
-      if (sp0_name.find("_sp0_") == std::string::npos)
-        continue;
-      recorded.insert(key);
-
-      // Log resizing operation
-      std::cout << "Resizing instance " << fullname + cellname
-                << " of type " << sp0_name
-                << " to type " << sp1_name << std::endl;
-
-      // Find the corresponding speed 1 Liberty cell
-      sta::LibertyCell* to_cell = library->findLibertyCell(sp1_name.c_str());
-      if (!to_cell) {
-        // Should never happen since we create Liberty cells for both speeds
-        std::cout << "WARNING: Missing cell model " << sp1_name << std::endl
-                  << "This should never happen!" << std::endl
-                  << "Final WNS: " << -(wns * 1e12) << std::endl
-                  << "Timing optimization partially done!" << std::endl;
-        return close_transforms();
-      }
+    // Journal record of this batch
+    JournalBatch batch;
+    batch.iter = cur_iter;
+    batch.wns = wns;
+    batch.wns_stall_rounds = wns_stall_rounds;
+
+    // For each offending cell, resize to the next speed grade. The swaps of
+    // all folded copies are collected and applied as one batch.
+    {
+      MetricsRecorder::Scope timing(&metrics, Phase::resize);
+      std::vector<CellSwap> swaps;
+      for (auto offender_pair : offenders) {
+        // Get the instance, cell, and Liberty cell
+        sta::Instance* offender = offender_pair.first;
+        sta::Cell* cell = network->cell(offender);
+        sta::LibertyCell* libcell = network->libertyCell(cell);
 
-      // Swap every folded copy of this (module, cell) to the speed 1 cell
-      auto fold_it = fold_insts.find(parentcellname + '\t' + cellname);
-      if (fold_it != fold_insts.end()) {
-        for (sta::Instance* leaf : fold_it->second) {
-          sta::LibertyCell* leaf_lib = network->libertyCell(network->cell(leaf));
-          if (!leaf_lib ||
-              std::string(leaf_lib->name()).find("_sp0_") == std::string::npos)
+        // Look up the fold group, skipping groups already swapped this batch
+        int fold = folds.find(offender);
+        if (fold < 0 || recorded_iter[fold] == cur_iter)
+          continue;
+        recorded_iter[fold] = cur_iter;
+
+        // Find the next faster Liberty cell
+        sta::LibertyCell* to_cell = ladder.faster(libcell);
+        if (!to_cell)
+          continue;
+
+        // Log resizing operation (written by the logger thread)
+        log(LogLevel::normal) << "Resizing instance "
+                              << prefixes.prefix(offender)
+                              << folds.cellName(fold) << " of type "
+                              << libcell->name() << " to type "
+                              << to_cell->name();
+
+        // Swap every folded copy of this (module, cell) one grade up
+        for (sta::Instance* leaf : folds.leaves(fold)) {
+          sta::LibertyCell* leaf_lib =
+              network->libertyCell(network->cell(leaf));
+          sta::LibertyCell* leaf_to =
+              leaf_lib ? ladder.faster(leaf_lib) : nullptr;
+          if (!leaf_to)
             continue;
-          Sta::sta()->replaceCell(leaf, to_cell);
+          swaps.push_back({leaf, leaf_to});
+          last_swapped.push_back(leaf);
         }
+
+        // Record the transformation for back-annotation in the folded model
+        // (unique module name/cell name)
+        transforms.add(folds.moduleName(fold), folds.cellName(fold));
+        batch.swaps.emplace_back(folds.moduleName(fold), folds.cellName(fold));
       }
+      for (const CellSwap &swap : swaps) replaceCell(swap.inst, swap.to);
+    }
+    metrics.current().swaps = last_swapped.size();
 
-      // Record the transformation for back-annotation in the folded model
-      // (unique module name/cell name)
-      transforms << parentcellname << "\t" << cellname << std::endl;
+    // Write the whole batch at once; a failed write is a hard error
+    {
+      MetricsRecorder::Scope timing(&metrics, Phase::output);
+      if (!transforms.flushBatch()) return finish();
     }
 
     // Get delta WNS and delta WNS fraction
@@ -366,84 +662,242 @@ int Silisizer::silisize(const char *workdir,
 
     // Print the abs delta WNS in between loops
     if (cur_iter > 0) {
-      std::cout << "Delta WNS: " << delta_wns * 1e12 << std::endl;
-      std::cout << "Delta WNS frac: " << delta_wns_frac << std::endl;
+      log(LogLevel::normal) << "Delta WNS: " << delta_wns * 1e12;
+      log(LogLevel::normal) << "Delta WNS frac: " << delta_wns_frac;
     }
 
-    // Set effort based on delta WNS when adaptive batching is enabled.
-    if (!upsize_all && delta_wns_frac < 0.1 && swaps_per_iter < 1048576)
-      swaps_per_iter *= 2;
-
-    // Print the current iteration and WNS
-    std::cout << "Iter " << cur_iter + 1 << std::endl;
-    std::cout << "Current WNS: " << -(wns * 1e12) << std::endl;
-
-    // DEBUG: Print the current effort and corresponding variables
-    if (DEBUG) {
-      std::cout << "******************************" << std::endl;
-      std::cout << "Current iter: " << cur_iter << std::endl;
-      std::cout << "------------------------------" << std::endl;
-      std::cout << "Previous WNS: " << -(previous_wns * 1e12) << std::endl;
-      std::cout << "Current WNS: " << -(wns * 1e12) << std::endl;
-      std::cout << "Delta WNS: " << delta_wns * 1e12 << std::endl;
-      std::cout << "Delta WNS frac: " << delta_wns_frac << std::endl;
-      std::cout << "------------------------------" << std::endl;
-      std::cout << "Swaps per iter: " << swaps_per_iter << std::endl;
-      std::cout << "******************************" << std::endl;
+    // Size the next batch from how the previous one moved WNS and TNS when
+    // adaptive batching is enabled.
+    if (!options.upsize_all)
+      swaps_per_iter = batch_controller->nextSize(
+          swaps_per_iter,
+          {previous_swaps, previous_wns, wns, previous_tns, tns});
+    batch.next_swaps_per_iter = swaps_per_iter;
+    {
+      MetricsRecorder::Scope timing(&metrics, Phase::output);
+      journal.append(batch, log);
     }
 
-    // Store previous WNS for delta calculation
+    // Print the current iteration and WNS
+    log(LogLevel::normal) << "Iter " << cur_iter + 1;
+    log(LogLevel::normal) << "Current WNS: " << -(wns * 1e12);
+
+    // Print the current effort and corresponding variables
+    log(LogLevel::verbose)
+        << "******************************\n"
+        << "Current iter: " << cur_iter << '\n'
+        << "------------------------------\n"
+        << "Previous WNS: " << -(previous_wns * 1e12) << '\n'
+        << "Current WNS: " << -(wns * 1e12) << '\n'
+        << "Delta WNS: " << delta_wns * 1e12 << '\n'
+        << "Delta WNS frac: " << delta_wns_frac << '\n'
+        << "------------------------------\n"
+        << "Swaps per iter: " << swaps_per_iter << '\n'
+        << "******************************";
+
+    // Store previous WNS, TNS and batch for delta calculation
     previous_wns = wns;
+    previous_tns = tns;
+    previous_swaps = batch.swaps.size();
+
+    metrics.endIteration();
+    if (!metrics.write(metrics_path))
+      log.error() << "silisize: failed writing " << metrics_path;
   }
   
   // Clean up
-  return close_transforms();
+  return finish();
 }
 
-// Remove escape characters from JSON output
-static std::string jsonName(std::string_view s) {
-  std::string out;
-  out.reserve(s.length());
-  for (char c : s) if (c != '\\') out.push_back(c);
-  return out;
+// Format `items` into one string per STA thread, in order, so the output is
+// identical for any thread count
+template <typename Item, typename Format>
+static std::vector<std::string> formatChunks(const std::vector<Item> &items,
+                                             Format format) {
+  int thread_count =
+      usefulThreads(sta::Sta::sta()->threadCount(), items.size());
+  std::vector<std::string> chunks(thread_count);
+  runThreads(thread_count, [&](int thread) {
+    auto [begin, end] = threadChunk(thread, thread_count, items.size());
+    for (size_t i = begin; i < end; i++) format(items[i], chunks[thread]);
+  });
+  return chunks;
+}
+
+// Items formatted per streamed chunk
+const size_t STREAM_CHUNK_ITEMS = 4096;
+
+// Format `items` in fixed-size chunks on the STA threads and pass each chunk
+// to `emit` on the calling thread, in order, as soon as it and every earlier
+// chunk are done. Workers stay at most two chunks per thread ahead of the
+// writer, so memory does not grow with the design.
+template <typename Item, typename Format, typename Emit>
+static void streamChunks(const std::vector<Item> &items, Format format,
+                         Emit emit) {
+  size_t chunk_count =
+      (items.size() + STREAM_CHUNK_ITEMS - 1) / STREAM_CHUNK_ITEMS;
+  int workers = usefulThreads(sta::Sta::sta()->threadCount(), items.size());
+  std::string chunk;
+  if (workers == 1) {
+    for (size_t c = 0; c < chunk_count; c++) {
+      size_t end = std::min(items.size(), (c + 1) * STREAM_CHUNK_ITEMS);
+      for (size_t i = c * STREAM_CHUNK_ITEMS; i < end; i++)
+        format(items[i], chunk);
+      emit(chunk);
+      chunk.clear();
+    }
+    return;
+  }
+
+  size_t window = 2 * workers;
+  std::vector<std::string> slots(window);
+  std::vector<bool> ready(window, false);
+  size_t claimed = 0;
+  size_t written = 0;
+  std::mutex mutex;
+  std::condition_variable changed;
+  // Thread 0 writes; the others format
+  runThreads(workers + 1, [&](int thread) {
+    if (thread == 0) {
+      for (size_t c = 0; c < chunk_count; c++) {
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          changed.wait(lock, [&] { return ready[c % window]; });
+          chunk.swap(slots[c % window]);
+          ready[c % window] = false;
+          written++;
+        }
+        changed.notify_all();
+        emit(chunk);
+        chunk.clear();
+      }
+      return;
+    }
+    std::string text;
+    while (true) {
+      size_t c;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] {
+          return claimed == chunk_count || claimed < written + window;
+        });
+        if (claimed == chunk_count) return;
+        c = claimed++;
+      }
+      size_t end = std::min(items.size(), (c + 1) * STREAM_CHUNK_ITEMS);
+      for (size_t i = c * STREAM_CHUNK_ITEMS; i < end; i++)
+        format(items[i], text);
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        slots[c % window].swap(text);
+        ready[c % window] = true;
+      }
+      changed.notify_all();
+      text.clear();
+    }
+  });
 }
 
-// JSON dumper for clock gating related instances
-void dumpIcgJson(const char *path) {
+// Writes ",\n    entry" items as the body of a JSON list or object, dropping
+// the separator of the first one
+class JsonEntries {
+ public:
+  explicit JsonEntries(JsonWriter &out) : out_(out) {}
+
+  void write(std::string_view entries) {
+    if (entries.empty()) return;
+    out_.write(first_ ? entries.substr(1) : entries);
+    first_ = false;
+  }
+  void close(const char *close) {
+    if (!first_) out_.write("\n  ");
+    out_.write(close);
+  }
+
+ private:
+  JsonWriter &out_;
+  bool first_ = true;
+};
+
+// JSON dumper for clock gating related instances. Gated registers are sorted
+// by name and ICGs keep the leaf iteration order; names and classification
+// are computed in parallel, and ICG entries are written chunk by chunk as
+// they are formatted. With `ndjson` every entry is written as its own
+// {"gated_flop": name} or {"icg": name, "cell": cell} line.
+void dumpIcgJson(const char *path, bool ndjson) {
   sta::Sta *sta = sta::Sta::sta();
   sta::Network *network = sta->network();
 
-  std::ofstream f(path);
-  if (!f.good()) {
-    std::cerr << "dump_icg_json: cannot open " << path << " for write" << std::endl;
+  JsonWriter out;
+  if (!out.open(path)) {
+    std::cerr << "dump_icg_json: cannot open " << path << " for write"
+              << std::endl;
     return;
   }
 
-  // Dump gated registers.
-  f << "{\n  \"gated_flops\": [";
-  bool first = true;
-  for (const sta::Instance *reg : sta->clockGatedRegisters()) {
-    if (!first) f << ",";
-    f << "\n    \"" << jsonName(network->pathName(reg)) << "\"";
-    first = false;
+  // Gated registers; sorting needs every name before the first is written
+  auto gated = sta->clockGatedRegisters();
+  std::vector<const sta::Instance *> regs(gated.begin(), gated.end());
+  std::vector<std::string> reg_names = formatChunks(
+      regs, [network](const sta::Instance *reg, std::string &chunk) {
+        appendJsonName(chunk, network->pathName(reg));
+        chunk.push_back('\n');
+      });
+  std::vector<std::string_view> sorted_regs;
+  for (const std::string &chunk : reg_names) {
+    std::string_view rest = chunk;
+    while (!rest.empty()) {
+      size_t end = rest.find('\n');
+      sorted_regs.push_back(rest.substr(0, end));
+      rest.remove_prefix(end + 1);
+    }
   }
-  f << (first ? "" : "\n  ") << "],\n  \"icgs\": {";
-
-  // Dump clock-gating instances mapped to their liberty cell names.
-  first = true;
-  std::unique_ptr<sta::LeafInstanceIterator> it(network->leafInstanceIterator());
-  while (it->hasNext()) {
-    sta::Instance *inst = it->next();
-    sta::Cell *cell = network->cell(inst);
-    if (!cell) continue;
-    sta::LibertyCell *lc = network->libertyCell(cell);
-    if (!lc || !lc->isClockGate()) continue;
-    if (!first) f << ",";
-    f << "\n    \"" << jsonName(network->pathName(inst))
-      << "\": \"" << jsonName(lc->name()) << "\"";
-    first = false;
+  std::sort(sorted_regs.begin(), sorted_regs.end());
+
+  if (ndjson) {
+    for (std::string_view reg : sorted_regs) {
+      out.write("{\"gated_flop\": ");
+      out.write(reg);
+      out.write("}\n");
+    }
+  } else {
+    out.write("{\n  \"gated_flops\": [");
+    JsonEntries entries(out);
+    for (std::string_view reg : sorted_regs) {
+      entries.write(",\n    ");
+      entries.write(reg);
+    }
+    entries.close("],\n  \"icgs\": {");
   }
-  f << (first ? "" : "\n  ") << "}\n}\n";
+
+  // Clock-gating instances mapped to their liberty cell names
+  std::vector<sta::Instance *> leaves;
+  std::unique_ptr<sta::LeafInstanceIterator> it(
+      network->leafInstanceIterator());
+  while (it->hasNext()) leaves.push_back(it->next());
+  JsonEntries icgs(out);
+  streamChunks(
+      leaves,
+      [network, ndjson](sta::Instance *inst, std::string &chunk) {
+        sta::Cell *cell = network->cell(inst);
+        if (!cell) return;
+        sta::LibertyCell *lc = network->libertyCell(cell);
+        if (!lc || !lc->isClockGate()) return;
+        chunk += ndjson ? "{\"icg\": " : ",\n    ";
+        appendJsonName(chunk, network->pathName(inst));
+        chunk += ndjson ? ", \"cell\": " : ": ";
+        appendJsonName(chunk, lc->name());
+        if (ndjson) chunk += "}\n";
+      },
+      [&](const std::string &chunk) {
+        if (ndjson)
+          out.write(chunk);
+        else
+          icgs.write(chunk);
+      });
+  if (!ndjson) icgs.close("}\n}\n");
+  if (!out.close())
+    std::cerr << "dump_icg_json: failed writing " << path << std::endl;
 }
 
 }  // namespace silisizer
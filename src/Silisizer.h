@@ -14,18 +14,87 @@
 // You should have received a copy of the GNU General Public License
 // along with this program. If not, see <https://www.gnu.org/licenses/>.
 
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "BatchController.h"
+#include "Logger.h"
+#include "OffenderScore.h"
 #include "sta/Sta.hh"
 
 namespace silisizer {
 
+// Convergence policy and effort knobs for one silisize run
+struct SilisizeOptions {
+  // Upsize every offender found in a timing pass (no adaptive batching)
+  bool upsize_all = false;
+  // Stop once WNS has not improved for several consecutive passes
+  bool stop_on_wns_stall = false;
+  // Re-time only the fanout cones of the cells swapped by the last batch
+  bool incremental = false;
+  // In incremental mode, re-time every endpoint once per this many passes
+  int full_retime_interval = 8;
+  // Re-apply the batches journaled by an earlier run and continue from there
+  bool resume = false;
+  // Write resized_cells.tsv.gz instead of resized_cells.tsv
+  bool compress_transforms = false;
+  // Score offenders from vertex slacks in one timing graph pass instead of
+  // enumerating a worst path per violating endpoint
+  bool graph_scoring = false;
+  // Snapshot path ends while the search visits them instead of collecting
+  // a PathEndSeq per query
+  bool stream_paths = false;
+  // Lower the path query group count as RSS nears this many MB (0 = none)
+  int memory_budget_mb = 0;
+  // Fork this many children per batch, each timing a different batch size
+  // (Linux only; 0 or 1 disables speculation)
+  int speculate = 0;
+  // Query and score every scene separately, merging the offender scores
+  // with per-scene weights (ignored with graph_scoring)
+  bool per_scene = false;
+  // Weight of each named scene in per-scene mode; unlisted scenes weigh 1
+  std::map<std::string, double> scene_weights;
+  // Chrome trace-event file of the sizing phases ("" = no trace)
+  std::string trace_path;
+  // Fill each batch with offenders on distinct violating paths (ignored with
+  // upsize_all, speculate and graph_scoring)
+  bool disjoint_batches = false;
+  // Presize the violating endpoints in this many forked worker processes,
+  // split by clock domain, before the global passes (Linux only; 0 or 1
+  // disables sharding)
+  int shards = 0;
+  // How the batch size follows the timing gain of the previous batch
+  BatchPolicy batch_policy = BatchPolicy::doubling;
+  // Stop cleanly after this many seconds of sizing (0 = no limit)
+  double max_time = 0.0;
+  // Stop cleanly after this many batches in this run (0 = no limit)
+  int max_iters = 0;
+  // Console output: results only, progress (default), or diagnostics too
+  LogLevel log_level = LogLevel::normal;
+};
+
+// One leaf cell replacement of a sizing batch. Batches are applied with one
+// Sta::replaceCell() per swap: it only marks the affected vertices invalid,
+// and the next timing query recomputes their union once.
+struct CellSwap {
+  sta::Instance *inst;
+  sta::LibertyCell *to;
+};
+
 class Silisizer : public sta::Sta {
  public:
   ~Silisizer() {}
   int silisize(const char *workdir,
-               bool upsize_all = false,
-               bool stop_on_wns_stall = false);
+               const SilisizeOptions &options = SilisizeOptions());
+  // Offender scores of one timing pass over the current design, per leaf
+  // instance, from path or graph scoring
+  OffenderScores offenderScores(bool graph_scoring);
 };
 
-void dumpIcgJson(const char *path);
+// Write the clock-gated registers and ICG cells as JSON, or as NDJSON lines
+void dumpIcgJson(const char *path, bool ndjson = false);
 
 }  // namespace silisizer
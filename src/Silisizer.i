@@ -19,6 +19,7 @@
 %inline %{
 
 extern void dump_icg_json(const char *path);
+extern void dump_icg_ndjson(const char *path);
 
 extern void test_abrt();
 extern void test_segv();
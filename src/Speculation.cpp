@@ -0,0 +1,144 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+#include "Speculation.h"
+
+#ifdef __linux__
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <iostream>
+#include <unordered_set>
+
+#include "sta/Liberty.hh"
+#include "sta/MinMax.hh"
+#include "sta/Network.hh"
+
+namespace silisizer {
+
+std::vector<size_t> speculativeSizes(size_t base, int candidates,
+                                     size_t available) {
+  std::vector<size_t> sizes;
+  size_t limit = std::min(available, MAX_SPECULATIVE_SWAPS);
+  size_t size = std::max<size_t>(base, 1);
+  for (int c = 0; c < candidates && size <= limit; c++, size *= 4)
+    sizes.push_back(size);
+  return sizes;
+}
+
+std::vector<CellSwap> foldSwaps(sta::Network *network, const FoldIndex &folds,
+                                const SpeedLadder &ladder,
+                                const std::vector<Offender> &offenders,
+                                size_t count, std::vector<int> *swapped) {
+  std::vector<CellSwap> swaps;
+  std::unordered_set<int> groups;
+  for (size_t i = 0; i < count && i < offenders.size(); i++) {
+    int fold = folds.find(offenders[i].first);
+    if (fold < 0 || !groups.insert(fold).second) continue;
+    size_t first = swaps.size();
+    for (sta::Instance *leaf : folds.leaves(fold)) {
+      sta::LibertyCell *from = network->libertyCell(network->cell(leaf));
+      sta::LibertyCell *to = from ? ladder.faster(from) : nullptr;
+      if (to) swaps.push_back({leaf, to});
+    }
+    if (swapped && swaps.size() > first) swapped->push_back(fold);
+  }
+  return swaps;
+}
+
+#ifdef __linux__
+
+size_t speculateBatchSize(Silisizer *sizer, const FoldIndex &folds,
+                          const SpeedLadder &ladder,
+                          const std::vector<Offender> &offenders,
+                          const std::vector<size_t> &sizes, double wns,
+                          Logger &log) {
+  // Children inherit only the forking thread, so the STA worker threads are
+  // stopped while they run and restored afterwards. The log writer is
+  // drained first so no half-written block is duplicated by a child.
+  int thread_count = sizer->threadCount();
+  sizer->setThreadCount(1);
+  log.flush();
+  std::cout.flush();
+  std::cerr.flush();
+
+  struct Child {
+    size_t size;
+    pid_t pid;
+    int fd;
+  };
+  std::vector<Child> children;
+  for (size_t size : sizes) {
+    int fds[2];
+    if (pipe(fds) != 0) break;
+    pid_t pid = fork();
+    if (pid < 0) {
+      close(fds[0]);
+      close(fds[1]);
+      break;
+    }
+    if (pid == 0) {
+      close(fds[0]);
+      for (const CellSwap &swap :
+           foldSwaps(sizer->network(), folds, ladder, offenders, size))
+        sizer->replaceCell(swap.inst, swap.to);
+      sta::Slack worst;
+      sta::Vertex *worst_vertex;
+      sizer->worstSlack(sta::MinMax::max(), worst, worst_vertex);
+      double child_wns = std::min(0.0, (double) worst);
+      ssize_t written = write(fds[1], &child_wns, sizeof(child_wns));
+      _exit(written == sizeof(child_wns) ? 0 : 1);
+    }
+    close(fds[1]);
+    children.push_back({size, pid, fds[0]});
+  }
+
+  size_t best_size = 0;
+  double best_gain = 0.0;
+  for (const Child &child : children) {
+    double child_wns;
+    ssize_t got = read(child.fd, &child_wns, sizeof(child_wns));
+    close(child.fd);
+    int status;
+    waitpid(child.pid, &status, 0);
+    if (got != sizeof(child_wns) || !WIFEXITED(status) ||
+        WEXITSTATUS(status) != 0)
+      continue;
+    double gain = (child_wns - wns) / child.size;
+    log(LogLevel::normal) << "Speculative batch of " << child.size
+                          << ": WNS " << -(child_wns * 1e12);
+    if (gain > best_gain) {
+      best_gain = gain;
+      best_size = child.size;
+    }
+  }
+
+  sizer->setThreadCount(thread_count);
+  return best_size;
+}
+
+#else
+
+size_t speculateBatchSize(Silisizer *, const FoldIndex &, const SpeedLadder &,
+                          const std::vector<Offender> &,
+                          const std::vector<size_t> &, double, Logger &) {
+  return 0;
+}
+
+#endif
+
+}  // namespace silisizer
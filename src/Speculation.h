@@ -0,0 +1,58 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "FoldIndex.h"
+#include "Logger.h"
+#include "OffenderQueue.h"
+#include "Silisizer.h"
+#include "SpeedLadder.h"
+
+namespace silisizer {
+
+// Largest batch a speculative candidate may try
+const size_t MAX_SPECULATIVE_SWAPS = 1048576;
+
+// Batch sizes tried by speculation: `base`, 4 * base, 16 * base, ... up to
+// `candidates` sizes, capped at `available` offenders
+std::vector<size_t> speculativeSizes(size_t base, int candidates,
+                                     size_t available);
+
+// Leaf swaps moving the fold groups of the first `count` offenders one speed
+// grade up, each group once, as the sizing loop applies them. The groups that
+// get at least one swap are appended to `swapped` when given.
+std::vector<CellSwap> foldSwaps(sta::Network *network, const FoldIndex &folds,
+                                const SpeedLadder &ladder,
+                                const std::vector<Offender> &offenders,
+                                size_t count,
+                                std::vector<int> *swapped = nullptr);
+
+// Fork one copy-on-write child per batch size in `sizes`. Each child applies
+// the fold swaps of the top `sizes[i]` of `offenders` (best first), re-times
+// the design and reports its WNS; the parent's design is never touched.
+// Returns the size with the largest WNS gain per swap over `wns`, or 0 when
+// no candidate improves WNS or forking is unavailable (non-Linux).
+size_t speculateBatchSize(Silisizer *sizer, const FoldIndex &folds,
+                          const SpeedLadder &ladder,
+                          const std::vector<Offender> &offenders,
+                          const std::vector<size_t> &sizes, double wns,
+                          Logger &log);
+
+}  // namespace silisizer
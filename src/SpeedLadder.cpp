@@ -0,0 +1,89 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+#include "SpeedLadder.h"
+
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "sta/Liberty.hh"
+#include "sta/Network.hh"
+
+namespace silisizer {
+
+// Split "NAME_spN_X" into the ladder name "NAME_sp*_X" and the speed N.
+// Returns false for cells that are not speed graded.
+static bool parseSpeed(const std::string &name, std::string &ladder,
+                       int &speed) {
+  for (size_t pos = name.find("_sp"); pos != std::string::npos;
+       pos = name.find("_sp", pos + 1)) {
+    size_t digits = pos + 3;
+    size_t end = digits;
+    while (end < name.size() && std::isdigit((unsigned char) name[end])) end++;
+    if (end == digits || end >= name.size() || name[end] != '_') continue;
+    // A speed that does not fit an int is a name, not a grade
+    errno = 0;
+    long value = std::strtol(name.c_str() + digits, nullptr, 10);
+    if (errno == ERANGE || value > INT_MAX) continue;
+    ladder = name.substr(0, digits) + '*' + name.substr(end);
+    speed = (int) value;
+    return true;
+  }
+  return false;
+}
+
+SpeedLadder::SpeedLadder(sta::Network *network, Logger &log) {
+  std::unique_ptr<sta::LibertyLibraryIterator> libs(
+      network->libertyLibraryIterator());
+  while (libs->hasNext()) {
+    sta::LibertyLibrary *library = libs->next();
+
+    // Ladders never cross libraries
+    std::map<std::string, std::map<int, sta::LibertyCell *>> ladders;
+    sta::LibertyCellIterator cells(library);
+    while (cells.hasNext()) {
+      sta::LibertyCell *cell = cells.next();
+      std::string ladder;
+      int speed;
+      if (parseSpeed(cell->name(), ladder, speed))
+        ladders[ladder][speed] = cell;
+    }
+
+    for (auto &[ladder, rungs] : ladders) {
+      for (auto it = rungs.begin(); it != rungs.end(); ++it) {
+        size_t id = it->second->id();
+        if (id >= grades_.size()) grades_.resize(id + 1);
+        SpeedGrade &grade = grades_[id];
+        cells_.push_back(it->second);
+        grade.speed = it->first;
+        auto next = std::next(it);
+        if (next != rungs.end() && next->first == it->first + 1)
+          grade.faster = next->second;
+        else if (it->first == 0)
+          // Should never happen since we create Liberty cells for both speeds
+          log(LogLevel::quiet) << "WARNING: Missing faster cell model for "
+                               << it->second->name();
+      }
+    }
+  }
+}
+
+}  // namespace silisizer
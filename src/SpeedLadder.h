@@ -0,0 +1,69 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Logger.h"
+#include "sta/Liberty.hh"
+#include "sta/Sta.hh"
+
+namespace silisizer {
+
+// Position of a Liberty cell on its speed ladder (NAME_sp0_X, NAME_sp1_X, ...)
+struct SpeedGrade {
+  // N in the _spN_ infix, or -1 for cells not on a ladder
+  int speed = -1;
+  // Next faster cell of the same ladder, or nullptr at the top
+  sta::LibertyCell *faster = nullptr;
+};
+
+// One-time index of every speed-graded Liberty cell in the loaded libraries.
+// Grades are kept in a dense table indexed by cell id, so classifying a cell
+// and finding its swap target are one array load and the hot loops never
+// touch cell names.
+class SpeedLadder {
+ public:
+  // An sp0 cell without an sp1 model is reported as a warning on `log` and
+  // treated as already at its fastest grade
+  SpeedLadder(sta::Network *network, Logger &log);
+
+  // Grade of `cell`, or nullptr if it is not on a speed ladder
+  const SpeedGrade *grade(const sta::LibertyCell *cell) const {
+    size_t id = cell->id();
+    return id < grades_.size() && grades_[id].speed >= 0 ? &grades_[id]
+                                                          : nullptr;
+  }
+  // Next faster cell, or nullptr if `cell` cannot be upsized
+  sta::LibertyCell *faster(const sta::LibertyCell *cell) const {
+    const SpeedGrade *g = grade(cell);
+    return g ? g->faster : nullptr;
+  }
+  bool isResizable(const sta::LibertyCell *cell) const {
+    return faster(cell) != nullptr;
+  }
+  size_t size() const { return cells_.size(); }
+  // Every graded cell, in library order
+  const std::vector<const sta::LibertyCell *> &cells() const { return cells_; }
+
+ private:
+  std::vector<SpeedGrade> grades_;
+  std::vector<const sta::LibertyCell *> cells_;
+};
+
+}  // namespace silisizer
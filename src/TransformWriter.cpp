@@ -0,0 +1,89 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+#include "TransformWriter.h"
+
+namespace silisizer {
+
+TransformWriter::~TransformWriter() {
+  closeFile();
+}
+
+bool TransformWriter::open(const std::string &path, bool compress) {
+  path_ = path;
+  failed_ = false;
+  const std::string gz_suffix = ".gz";
+  bool suffixed = path.size() > gz_suffix.size() &&
+                  path.compare(path.size() - gz_suffix.size(),
+                               gz_suffix.size(), gz_suffix) == 0;
+  if (!compress)
+    std::remove((path + gz_suffix).c_str());
+  else if (suffixed)
+    std::remove(path.substr(0, path.size() - gz_suffix.size()).c_str());
+  if (compress)
+    gz_ = gzopen(path.c_str(), "wb");
+  else
+    file_ = std::fopen(path.c_str(), "wb");
+  if (!file_ && !gz_) return false;
+  add("Scope", "Instance");
+  return flushBatch();
+}
+
+void TransformWriter::add(std::string_view module, std::string_view cell) {
+  buffer_.append(module);
+  buffer_.push_back('\t');
+  buffer_.append(cell);
+  buffer_.push_back('\n');
+}
+
+bool TransformWriter::flushBatch() {
+  if (failed_ || buffer_.empty()) return !failed_;
+  if (gz_) {
+    // A sync flush per batch keeps everything written so far decodable
+    failed_ = gzwrite(gz_, buffer_.data(), buffer_.size()) !=
+                  (int) buffer_.size() ||
+              gzflush(gz_, Z_SYNC_FLUSH) != Z_OK;
+  } else if (file_) {
+    failed_ = std::fwrite(buffer_.data(), 1, buffer_.size(), file_) !=
+                  buffer_.size() ||
+              std::fflush(file_) != 0;
+  } else {
+    failed_ = true;
+  }
+  buffer_.clear();
+  return !failed_;
+}
+
+int TransformWriter::close(Logger &log) {
+  if (closeFile()) return 0;
+  log.error() << "silisize: failed writing " << path_;
+  return 1;
+}
+
+bool TransformWriter::closeFile() {
+  if (!file_ && !gz_) return !failed_;
+  flushBatch();
+  if (gz_) {
+    if (gzclose(gz_) != Z_OK) failed_ = true;
+    gz_ = nullptr;
+  }
+  if (file_) {
+    if (std::fclose(file_) != 0) failed_ = true;
+    file_ = nullptr;
+  }
+  return !failed_;
+}
+
+}  // namespace silisizer
@@ -0,0 +1,63 @@
+// Silisizer: resize operator-level cells to resolve timing violations
+// Copyright (c) 2024, Silimate Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <zlib.h>
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#include "Logger.h"
+
+namespace silisizer {
+
+// Writer for the back-annotation TSV (resized_cells.tsv). Rows are buffered
+// in memory and written once per sizing batch, so the file only ever ends on
+// a complete row and large -all batches do not turn into one tiny write per
+// resized cell. Optionally gzip-compressed.
+class TransformWriter {
+ public:
+  ~TransformWriter();
+
+  // Create `path` and write the header row. A list left in the other format
+  // by an earlier run (`path` with or without ".gz") is removed, so only this
+  // run's list is ever back-annotated. Returns false if it cannot be created.
+  bool open(const std::string &path, bool compress);
+  // Buffer one (module, cell) row
+  void add(std::string_view module, std::string_view cell);
+  // Write the buffered rows in one go and flush them to the file. Returns
+  // false once any write has failed.
+  bool flushBatch();
+  // Flush and close the file, surfacing any write failure (disk full, NFS
+  // stale handle, flush error) as a hard error, so Preqorsor never
+  // back-annotates a truncated file. Returns 0 on success, 1 on failure
+  // after reporting it on `log`.
+  int close(Logger &log);
+
+ private:
+  // Flush and close the file if open. Returns false once any write failed.
+  bool closeFile();
+
+  std::string path_;
+  std::string buffer_;
+  std::FILE *file_ = nullptr;
+  gzFile gz_ = nullptr;
+  bool failed_ = false;
+};
+
+}  // namespace silisizer
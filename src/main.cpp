@@ -16,6 +16,7 @@
 
 #include <iostream>
 
+#include "Server.h"
 #include "Silisizer.h"
 #include "sta/StaMain.hh"
 #include "StaConfig.hh"  // TCL_READLINE
@@ -69,11 +70,13 @@ parseThreadsArg(int &argc,
 }
 
 static void showUsage(char *prog) {
-  printf("Usage: %s [-help] [-version] [-threads count|max] cmd_file\n",
+  printf("Usage: %s [-help] [-version] [-threads count|max] "
+         "[-server socket] cmd_file\n",
          prog);
   printf("  -help              show help and exit\n");
   printf("  -version           show version and exit\n");
   printf("  -threads count|max use count threads\n");
+  printf("  -server socket     after cmd_file, serve requests on socket\n");
   printf("  cmd_file           source cmd_file and exit\n");
 }
 
@@ -98,41 +101,206 @@ static int silisizer_argc;
 static char **silisizer_argv;
 static Silisizer *sizer = nullptr;
 
-// Tcl command wrapper for sta::silisize. It parses convergence policy flags
-// and borrows the workdir string from objv for the duration of this call.
+// Tcl command wrapper for sta::silisize. It parses convergence policy and
+// effort flags and borrows the workdir string from objv for the duration of
+// this call.
 static int silisizeTclCmd(ClientData,
                           Tcl_Interp *interp,
                           int objc,
                           Tcl_Obj *const objv[]) {
-  bool upsize_all = false;
-  bool stop_on_wns_stall = false;
+  const char *usage =
+      "?-all? ?-wns? ?-incremental? ?-full_retime passes? ?-resume? ?-gzip? "
+      "?-trace file? ?-graph_scoring? ?-per_scene? ?-scene_weights weights? "
+      "?-speculate children? ?-stream_paths? ?-memory_budget mb? "
+      "?-max_time seconds? ?-max_iters iterations? "
+      "?-batch_policy doubling|predictive? ?-disjoint? ?-shards workers? "
+      "?-quiet|-verbose? workdir";
+  SilisizeOptions options;
   const char *workdir = nullptr;
 
   for (int i = 1; i < objc; i++) {
     std::string arg = Tcl_GetString(objv[i]);
     if (arg == "-all")
-      upsize_all = true;
+      options.upsize_all = true;
     else if (arg == "-wns")
-      stop_on_wns_stall = true;
-    else if (!arg.empty() && arg[0] == '-') {
-      std::string message =
-          "unknown option \"" + arg + "\": must be -all or -wns";
+      options.stop_on_wns_stall = true;
+    else if (arg == "-incremental")
+      options.incremental = true;
+    else if (arg == "-resume")
+      options.resume = true;
+    else if (arg == "-gzip")
+      options.compress_transforms = true;
+    else if (arg == "-graph_scoring")
+      options.graph_scoring = true;
+    else if (arg == "-stream_paths")
+      options.stream_paths = true;
+    else if (arg == "-per_scene")
+      options.per_scene = true;
+    else if (arg == "-disjoint")
+      options.disjoint_batches = true;
+    else if (arg == "-quiet")
+      options.log_level = LogLevel::quiet;
+    else if (arg == "-verbose")
+      options.log_level = LogLevel::verbose;
+    else if (arg == "-scene_weights") {
+      // {scene weight ?scene weight ...?}
+      if (i + 1 >= objc) {
+        Tcl_WrongNumArgs(interp, 1, objv, usage);
+        return TCL_ERROR;
+      }
+      int count;
+      Tcl_Obj **elements;
+      if (Tcl_ListObjGetElements(interp, objv[++i], &count, &elements) !=
+          TCL_OK)
+        return TCL_ERROR;
+      if (count % 2) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj(
+            "-scene_weights must be a list of scene weight pairs", -1));
+        return TCL_ERROR;
+      }
+      for (int e = 0; e < count; e += 2) {
+        double weight;
+        if (Tcl_GetDoubleFromObj(interp, elements[e + 1], &weight) != TCL_OK)
+          return TCL_ERROR;
+        if (weight < 0.0) {
+          Tcl_SetObjResult(interp, Tcl_NewStringObj(
+              "-scene_weights must not be negative", -1));
+          return TCL_ERROR;
+        }
+        options.scene_weights[Tcl_GetString(elements[e])] = weight;
+      }
+      options.per_scene = true;
+    }
+    else if (arg == "-full_retime") {
+      if (i + 1 >= objc) {
+        Tcl_WrongNumArgs(interp, 1, objv, usage);
+        return TCL_ERROR;
+      }
+      int passes;
+      if (Tcl_GetIntFromObj(interp, objv[++i], &passes) != TCL_OK)
+        return TCL_ERROR;
+      if (passes < 1) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj(
+            "-full_retime must be a positive integer", -1));
+        return TCL_ERROR;
+      }
+      options.full_retime_interval = passes;
+    } else if (arg == "-speculate") {
+      if (i + 1 >= objc) {
+        Tcl_WrongNumArgs(interp, 1, objv, usage);
+        return TCL_ERROR;
+      }
+      int children;
+      if (Tcl_GetIntFromObj(interp, objv[++i], &children) != TCL_OK)
+        return TCL_ERROR;
+      if (children < 1) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj(
+            "-speculate must be a positive integer", -1));
+        return TCL_ERROR;
+      }
+      options.speculate = children;
+    } else if (arg == "-shards") {
+      if (i + 1 >= objc) {
+        Tcl_WrongNumArgs(interp, 1, objv, usage);
+        return TCL_ERROR;
+      }
+      int workers;
+      if (Tcl_GetIntFromObj(interp, objv[++i], &workers) != TCL_OK)
+        return TCL_ERROR;
+      if (workers < 1) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj(
+            "-shards must be a positive integer", -1));
+        return TCL_ERROR;
+      }
+      options.shards = workers;
+    } else if (arg == "-memory_budget") {
+      if (i + 1 >= objc) {
+        Tcl_WrongNumArgs(interp, 1, objv, usage);
+        return TCL_ERROR;
+      }
+      int megabytes;
+      if (Tcl_GetIntFromObj(interp, objv[++i], &megabytes) != TCL_OK)
+        return TCL_ERROR;
+      if (megabytes < 1) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj(
+            "-memory_budget must be a positive number of MB", -1));
+        return TCL_ERROR;
+      }
+      options.memory_budget_mb = megabytes;
+    } else if (arg == "-max_time") {
+      if (i + 1 >= objc) {
+        Tcl_WrongNumArgs(interp, 1, objv, usage);
+        return TCL_ERROR;
+      }
+      double seconds;
+      if (Tcl_GetDoubleFromObj(interp, objv[++i], &seconds) != TCL_OK)
+        return TCL_ERROR;
+      if (!(seconds > 0.0)) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj(
+            "-max_time must be a positive number of seconds", -1));
+        return TCL_ERROR;
+      }
+      options.max_time = seconds;
+    } else if (arg == "-max_iters") {
+      if (i + 1 >= objc) {
+        Tcl_WrongNumArgs(interp, 1, objv, usage);
+        return TCL_ERROR;
+      }
+      int iterations;
+      if (Tcl_GetIntFromObj(interp, objv[++i], &iterations) != TCL_OK)
+        return TCL_ERROR;
+      if (iterations < 1) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj(
+            "-max_iters must be a positive integer", -1));
+        return TCL_ERROR;
+      }
+      options.max_iters = iterations;
+    } else if (arg == "-batch_policy") {
+      if (i + 1 >= objc) {
+        Tcl_WrongNumArgs(interp, 1, objv, usage);
+        return TCL_ERROR;
+      }
+      std::string policy = Tcl_GetString(objv[++i]);
+      if (policy == "doubling")
+        options.batch_policy = BatchPolicy::doubling;
+      else if (policy == "predictive")
+        options.batch_policy = BatchPolicy::predictive;
+      else {
+        std::string message = "unknown batch policy \"" + policy +
+                              "\": must be doubling or predictive";
+        Tcl_SetObjResult(interp, Tcl_NewStringObj(message.c_str(), -1));
+        return TCL_ERROR;
+      }
+    } else if (arg == "-trace") {
+      if (i + 1 >= objc) {
+        Tcl_WrongNumArgs(interp, 1, objv, usage);
+        return TCL_ERROR;
+      }
+      options.trace_path = Tcl_GetString(objv[++i]);
+    } else if (!arg.empty() && arg[0] == '-') {
+      std::string message = "unknown option \"" + arg +
+                            "\": must be -all, -wns, -incremental, "
+                            "-full_retime, -resume, -gzip, -trace, "
+                            "-graph_scoring, -per_scene, -scene_weights, "
+                            "-speculate, -stream_paths, -memory_budget, "
+                            "-max_time, -max_iters, -batch_policy, -disjoint, "
+                            "-shards, -quiet or -verbose";
       Tcl_SetObjResult(interp, Tcl_NewStringObj(message.c_str(), -1));
       return TCL_ERROR;
     } else if (!workdir)
       workdir = Tcl_GetString(objv[i]);
     else {
-      Tcl_WrongNumArgs(interp, 1, objv, "?-all? ?-wns? workdir");
+      Tcl_WrongNumArgs(interp, 1, objv, usage);
       return TCL_ERROR;
     }
   }
 
   if (!workdir) {
-    Tcl_WrongNumArgs(interp, 1, objv, "?-all? ?-wns? workdir");
+    Tcl_WrongNumArgs(interp, 1, objv, usage);
     return TCL_ERROR;
   }
 
-  int status = sizer->silisize(workdir, upsize_all, stop_on_wns_stall);
+  int status = sizer->silisize(workdir, options);
   if (status != 0) {
     std::string message =
         "silisize failed with status " + std::to_string(status);
@@ -143,10 +311,39 @@ static int silisizeTclCmd(ClientData,
   return TCL_OK;
 }
 
+// Tcl command wrapper for sta::offender_scores. Returns a dict of leaf
+// instance path name to offender score for the current design.
+static int offenderScoresTclCmd(ClientData,
+                                Tcl_Interp *interp,
+                                int objc,
+                                Tcl_Obj *const objv[]) {
+  bool graph_scoring = false;
+  for (int i = 1; i < objc; i++) {
+    if (std::string(Tcl_GetString(objv[i])) != "-graph_scoring") {
+      Tcl_WrongNumArgs(interp, 1, objv, "?-graph_scoring?");
+      return TCL_ERROR;
+    }
+    graph_scoring = true;
+  }
+
+  sta::Network *network = sizer->network();
+  Tcl_Obj *scores = Tcl_NewDictObj();
+  for (const auto &[inst, score] : sizer->offenderScores(graph_scoring))
+    Tcl_DictObjPut(interp, scores,
+                   Tcl_NewStringObj(network->pathName(inst), -1),
+                   Tcl_NewDoubleObj(score.score));
+  Tcl_SetObjResult(interp, scores);
+  return TCL_OK;
+}
+
 void dump_icg_json(const char *path) {
   silisizer::dumpIcgJson(path);
 }
 
+void dump_icg_ndjson(const char *path) {
+  silisizer::dumpIcgJson(path, true);
+}
+
 void segv_call_fn() {
   int a;
   a = 6;
@@ -234,6 +431,11 @@ static int silisizerTclAppInit(Tcl_Interp *interp) {
                        silisizeTclCmd,
                        nullptr,
                        nullptr);
+  Tcl_CreateObjCommand(interp,
+                       "sta::offender_scores",
+                       offenderScoresTclCmd,
+                       nullptr,
+                       nullptr);
   Sta_Init(interp);
 
   sta::Sta *sta = sta::Sta::sta();
@@ -250,6 +452,8 @@ static int silisizerTclAppInit(Tcl_Interp *interp) {
   Tcl_Eval(interp, "namespace import sta::*");
 
   bool exit_after_cmd_file = sta::findCmdLineFlag(argc, argv, "-exit");
+  // Serve sizing requests against the design loaded by cmd_file
+  char *server_socket = findCmdLineKey(argc, argv, "-server");
 
   if (argc > 2 || (argc > 1 && argv[1][0] == '-'))
     showUsage(argv[0]);
@@ -258,9 +462,10 @@ static int silisizerTclAppInit(Tcl_Interp *interp) {
       char *cmd_file = argv[1];
       if (cmd_file) {
         sta::sourceTclFile(cmd_file, false, false, interp);
-        if (exit_after_cmd_file) exit(EXIT_SUCCESS);
+        if (exit_after_cmd_file && !server_socket) exit(EXIT_SUCCESS);
       }
     }
+    if (server_socket) exit(serveRequests(interp, sta, server_socket));
   }
 #if TCL_READLINE
   // Only enter the tclreadline loop if it actually loaded above. Otherwise fall
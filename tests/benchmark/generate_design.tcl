@@ -0,0 +1,109 @@
+# Synthetic sizing workload generator.
+#
+# The design is a bank of independent BUF_sp0_X1 chains, `depth` cells long.
+# Chains are instances of `chains / fold` unique modules, so every resize
+# applies to `fold` leaf copies the way a folded Preqorsor netlist does. Chains
+# driving `out` violate until all of their cells are at sp1; chains driving
+# `slack_out` have positive slack. `density` is the fraction of violating
+# chains, spread evenly over the bank. With `clocks` above one the bank is cut
+# into that many contiguous blocks, each timed by its own clock.
+
+# Chain count for about `leaves` leaf instances, rounded up to whole folds
+proc benchmark_chain_count {leaves depth fold} {
+    set chains [expr {max(1, ($leaves + $depth - 1) / $depth)}]
+    return [expr {(($chains + $fold - 1) / $fold) * $fold}]
+}
+
+# True if chain `i` drives a violating endpoint
+proc benchmark_chain_violates {i density} {
+    return [expr {int(($i + 1) * $density) > int($i * $density)}]
+}
+
+# Write benchmark.v and benchmark.sdc into `dir`. Returns the number of leaf
+# instances.
+proc write_benchmark_design {dir leaves depth fold density {clocks 1}} {
+    set chains [benchmark_chain_count $leaves $depth $fold]
+    set modules [expr {$chains / $fold}]
+    set violating 0
+    for {set i 0} {$i < $chains} {incr i} {
+        incr violating [benchmark_chain_violates $i $density]
+    }
+    set slack [expr {$chains - $violating}]
+
+    set v [open [file join $dir benchmark.v] w]
+    fconfigure $v -buffering full -buffersize 1048576
+    for {set m 0} {$m < $modules} {incr m} {
+        puts $v "module bench_fold_${m}(input a, output y);"
+        for {set d 1} {$d < $depth} {incr d} {
+            puts $v "  wire n$d;"
+        }
+        for {set d 0} {$d < $depth} {incr d} {
+            set in [expr {$d == 0 ? "a" : "n$d"}]
+            set out [expr {$d == $depth - 1 ? "y" : "n[expr {$d + 1}]"}]
+            puts $v "  BUF_sp0_X1 u${d}(.A($in), .Y($out));"
+        }
+        puts $v "endmodule"
+    }
+
+    set ports [list "input \[[expr {$chains - 1}]:0\] in"]
+    if {$violating} {
+        lappend ports "output \[[expr {$violating - 1}]:0\] out"
+    }
+    if {$slack} {
+        lappend ports "output \[[expr {$slack - 1}]:0\] slack_out"
+    }
+    puts $v "module benchmark([join $ports {, }]);"
+    set out_bit 0
+    set slack_bit 0
+    for {set i 0} {$i < $chains} {incr i} {
+        if {[benchmark_chain_violates $i $density]} {
+            set y "out\[$out_bit\]"
+            incr out_bit
+        } else {
+            set y "slack_out\[$slack_bit\]"
+            incr slack_bit
+        }
+        if {$clocks > 1} {
+            set clock [expr {$i * $clocks / $chains}]
+            lappend clock_inputs($clock) "in\[$i\]"
+            lappend clock_outputs($clock) $y
+        }
+        puts $v "  bench_fold_[expr {$i % $modules}] chain_${i}(.a(in\[$i\]),\
+            .y($y));"
+    }
+    puts $v "endmodule"
+    close $v
+
+    # sp0 chains take 0.5 per stage and sp1 chains 0.2, so a 0.4 per stage
+    # period fails only until a chain is upsized. Slack chains get 0.2 per
+    # stage of extra margin.
+    set sdc [open [file join $dir benchmark.sdc] w]
+    if {$clocks > 1} {
+        for {set k 0} {$k < $clocks} {incr k} {
+            if {![info exists clock_inputs($k)]} continue
+            puts $sdc "create_clock -name bench_clk_$k -period\
+                [expr {0.4 * $depth}]"
+            puts $sdc "set_input_delay 0.0 -clock bench_clk_$k\
+                \[get_ports {$clock_inputs($k)}\]"
+            foreach y $clock_outputs($k) {
+                set delay [expr {[string match slack_out* $y] ?
+                                 -0.2 * $depth : 0.0}]
+                puts $sdc "set_output_delay $delay -clock bench_clk_$k\
+                    \[get_ports {$y}\]"
+            }
+        }
+        close $sdc
+        return [expr {$chains * $depth}]
+    }
+    puts $sdc "create_clock -name bench_clk -period [expr {0.4 * $depth}]"
+    puts $sdc "set_input_delay 0.0 -clock bench_clk \[get_ports in*\]"
+    if {$violating} {
+        puts $sdc "set_output_delay 0.0 -clock bench_clk \[get_ports out*\]"
+    }
+    if {$slack} {
+        puts $sdc "set_output_delay [expr {-0.2 * $depth}] -clock bench_clk\
+            \[get_ports slack_out*\]"
+    }
+    close $sdc
+    return [expr {$chains * $depth}]
+}
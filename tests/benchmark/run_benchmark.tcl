@@ -0,0 +1,75 @@
+# Run silisize on a generated design and summarize silisize_metrics.json.
+#
+# Sizes come from the environment so the same script serves the smoke test
+# and the `benchmark` target:
+#   SILISIZER_BENCH_LEAVES   leaf instances (default 10000)
+#   SILISIZER_BENCH_DEPTH    cells per chain (default 16)
+#   SILISIZER_BENCH_FOLD     leaf copies per folded module (default 4)
+#   SILISIZER_BENCH_DENSITY  fraction of violating chains (default 0.5)
+#   SILISIZER_BENCH_CLOCKS   clock domains (default 1)
+#   SILISIZER_BENCH_FLAGS    extra sta::silisize flags, e.g. "-incremental"
+#   SILISIZER_BENCH_DIR      work directory (default ./bench_work)
+
+source [file join [file dirname [info script]] generate_design.tcl]
+
+proc bench_env {name default} {
+    if {[info exists ::env($name)] && $::env($name) ne ""} {
+        return $::env($name)
+    }
+    return $default
+}
+
+set leaves [bench_env SILISIZER_BENCH_LEAVES 10000]
+set depth [bench_env SILISIZER_BENCH_DEPTH 16]
+set fold [bench_env SILISIZER_BENCH_FOLD 4]
+set density [bench_env SILISIZER_BENCH_DENSITY 0.5]
+set clocks [bench_env SILISIZER_BENCH_CLOCKS 1]
+set flags [bench_env SILISIZER_BENCH_FLAGS ""]
+set workdir [file normalize [bench_env SILISIZER_BENCH_DIR bench_work]]
+
+file delete -force $workdir
+file mkdir [file join $workdir data]
+
+set start [clock milliseconds]
+set leaf_count [write_benchmark_design $workdir $leaves $depth $fold $density \
+    $clocks]
+puts "Benchmark: $leaf_count leaves, depth $depth, fold $fold,\
+    density $density, $clocks clocks"
+read_liberty [file join [file dirname [info script]] benchmark.lib]
+read_verilog [file join $workdir benchmark.v]
+link_design benchmark
+source [file join $workdir benchmark.sdc]
+set load_seconds [expr {([clock milliseconds] - $start) / 1000.0}]
+
+if {[catch {sta::silisize {*}$flags $workdir} result] || $result != 0} {
+    puts "BENCHMARK: FAIL (silisize: $result)"
+    exit 1
+}
+
+set stream [open [file join $workdir data silisize_metrics.json] r]
+set metrics [read $stream]
+close $stream
+
+set iterations [regexp -all {"iter": } $metrics]
+regexp {"totals": (\{[^\n]*\}),\n} $metrics -> totals
+regexp {"wall": ([0-9.e+-]+),\n} $metrics -> wall
+regexp {"peak_rss_bytes": ([0-9]+)} $metrics -> peak_rss
+
+puts "Load and link: [format %.2f $load_seconds] s"
+puts "Iterations: $iterations"
+foreach phase {find_paths score rank resize output} {
+    regexp "\"$phase\": \\{\"wall\": (\[0-9.e+-\]+), \"cpu\": (\[0-9.e+-\]+)\\}" \
+        $totals -> phase_wall phase_cpu
+    puts [format "  %-10s wall %8.3f s  cpu %8.3f s" $phase $phase_wall \
+        $phase_cpu]
+}
+puts "Sizing wall: [format %.3f $wall] s"
+puts "Peak RSS: [format %.1f [expr {$peak_rss / 1048576.0}]] MB"
+
+# Every violating chain has to end up fully at sp1
+set wns [worst_slack -max]
+if {$wns < 0.0} {
+    puts "BENCHMARK: FAIL (WNS $wns after sizing)"
+    exit 1
+}
+puts "BENCHMARK: PASS"
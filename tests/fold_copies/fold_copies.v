@@ -0,0 +1,22 @@
+// Two copies of one folded module next to a lone top-level buffer. Each copy
+// of stage/drv gains less from an upsize than solo does, but together they
+// gain more.
+module stage(
+    input a,
+    output y
+);
+  BUF_sp0_X1 drv(.A(a), .Y(y));
+endmodule
+
+module fold_copies(
+    input a0,
+    input a1,
+    input b,
+    output y0,
+    output y1,
+    output z
+);
+  stage u0(.a(a0), .y(y0));
+  stage u1(.a(a1), .y(y1));
+  BUF_sp0_X1 solo(.A(b), .Y(z));
+endmodule
@@ -0,0 +1,57 @@
+# Folded copies are one ECO: their scores are summed into one (module, cell)
+# group, and resizing the group swaps every copy at once.
+set workdir [file normalize [file join [pwd] work]]
+file delete -force $workdir
+file mkdir [file join $workdir data]
+
+read_liberty ../wns_policy/wns_policy.lib
+read_verilog fold_copies.v
+link_design fold_copies
+
+# Both copies violate by 0.2ns and solo by 0.3ns; an upsize removes 0.4ns
+create_clock -name test_clk -period 0.5
+set_input_delay 0.2 -clock test_clk [get_ports {a0 a1}]
+set_input_delay 0.3 -clock test_clk [get_ports b]
+set_output_delay 0.0 -clock test_clk [get_ports {y0 y1 z}]
+
+proc fail {message} {
+    global workdir
+    puts "FOLD_COPIES_TEST: FAIL ($message)"
+    file delete -force $workdir
+    exit 1
+}
+
+proc same_score {a b} {
+    return [expr {abs($a - $b) <= 1e-6 * max(abs($a), abs($b), 1e-12)}]
+}
+
+# Leaf by leaf, solo is the worst offender
+set scores [sta::offender_scores]
+foreach {inst expected} {u0/drv 0.2e-9 u1/drv 0.2e-9 solo 0.3e-9} {
+    if {![dict exists $scores $inst] ||
+        ![same_score [dict get $scores $inst] $expected]} {
+        fail "$inst scores [dict get $scores $inst], expected $expected"
+    }
+}
+
+# Summed over its copies, stage/drv is, so a one-cell batch takes it
+if {[catch {sta::silisize -max_iters 1 $workdir} result] || $result != 0} {
+    fail "silisize: $result"
+}
+set transforms [open [file join $workdir data resized_cells.tsv] r]
+set lines [split [string trim [read $transforms]] "\n"]
+close $transforms
+file delete -force $workdir
+if {[lrange $lines 1 end] ne [list "stage\tdrv"]} {
+    fail "first batch resized [lrange $lines 1 end], expected stage drv"
+}
+
+# Every copy got the same swap, and nothing else changed
+foreach {inst expected} {u0/drv BUF_sp1_X1 u1/drv BUF_sp1_X1 solo BUF_sp0_X1} {
+    set cell [get_property [get_cells $inst] ref_name]
+    if {$cell ne $expected} {
+        fail "$inst is $cell, expected $expected"
+    }
+}
+
+puts "FOLD_COPIES_TEST: PASS"
@@ -0,0 +1,42 @@
+# Offenders are ranked by the delay an upsize removes, not by how many
+# violating paths they are on: u_shared is on three paths and u_big on one,
+# yet u_big must rank first.
+read_liberty gain_ranking.lib
+read_verilog gain_ranking.v
+link_design gain_ranking
+
+# y0..y2 violate by 0.6ns and z by 0.5ns
+create_clock -name test_clk -period 0.5
+set_input_delay 0.0 -clock test_clk [get_ports {a b}]
+set_output_delay 0.0 -clock test_clk [get_ports {y0 y1 y2 z}]
+
+proc fail {message} {
+    puts "GAIN_RANKING_TEST: FAIL ($message)"
+    exit 1
+}
+
+proc same_score {a b} {
+    return [expr {abs($a - $b) <= 1e-6 * max(abs($a), abs($b), 1e-12)}]
+}
+
+set scores [sta::offender_scores]
+foreach inst {u_shared u_big} {
+    if {![dict exists $scores $inst]} {
+        fail "$inst was not scored"
+    }
+}
+
+# Three paths at 0.05ns each against one path capped at its 0.5ns violation
+if {![same_score [dict get $scores u_shared] 0.15e-9]} {
+    fail "u_shared scores [dict get $scores u_shared], expected 0.15ns"
+}
+if {![same_score [dict get $scores u_big] 0.5e-9]} {
+    fail "u_big scores [dict get $scores u_big], expected 0.5ns"
+}
+
+# Counting paths would put u_shared first
+if {[dict get $scores u_big] <= [dict get $scores u_shared]} {
+    fail "u_shared outranks u_big"
+}
+
+puts "GAIN_RANKING_TEST: PASS"
@@ -0,0 +1,15 @@
+module icg_json(
+    input clk,
+    input en,
+    input d,
+    output q0,
+    output q1,
+    output q2
+);
+  wire gclk;
+
+  sky130_fd_sc_hd__dlclkp_1 icg_0(.CLK(clk), .GATE(en), .GCLK(gclk));
+  sky130_fd_sc_hd__dfxtp_1 gated_1(.CLK(gclk), .D(d), .Q(q1));
+  sky130_fd_sc_hd__dfxtp_1 gated_0(.CLK(gclk), .D(d), .Q(q0));
+  sky130_fd_sc_hd__dfxtp_1 free_0(.CLK(clk), .D(d), .Q(q2));
+endmodule
@@ -0,0 +1,70 @@
+# dump_icg_json and dump_icg_ndjson must list the same gated registers, in
+# the same sorted order, and the same ICGs with their liberty cells
+set workdir [file normalize [file join [pwd] work]]
+file delete -force $workdir
+file mkdir $workdir
+
+read_liberty ../common/sky130_fd_sc_hd__tt_025C_1v80.lib.gz
+read_verilog icg_json.v
+link_design icg_json
+
+create_clock -name clk -period 10.0 [get_ports clk]
+
+proc read_file {path} {
+    set f [open $path r]
+    set text [read $f]
+    close $f
+    return $text
+}
+
+proc fail {workdir message} {
+    puts "ICG_JSON_TEST: FAIL ($message)"
+    file delete -force $workdir
+    exit 1
+}
+
+set json_path [file join $workdir icg.json]
+set ndjson_path [file join $workdir icg.ndjson]
+sta::dump_icg_json $json_path
+sta::dump_icg_ndjson $ndjson_path
+set json [read_file $json_path]
+set ndjson [read_file $ndjson_path]
+file delete -force $workdir
+
+if {![regexp {"gated_flops": \[([^\]]*)\]} $json -> flops_body]} {
+    fail $workdir "no gated_flops list in JSON"
+}
+if {![regexp {"icgs": \{([^\}]*)\}} $json -> icgs_body]} {
+    fail $workdir "no icgs object in JSON"
+}
+set json_flops [regexp -all -inline {"[^"]*"} $flops_body]
+set json_icgs [regexp -all -inline {"[^"]*": "[^"]*"} $icgs_body]
+
+set nd_flops {}
+set nd_icgs {}
+foreach line [split [string trim $ndjson] "\n"] {
+    if {[regexp {^\{"gated_flop": ("[^"]*")\}$} $line -> name]} {
+        lappend nd_flops $name
+    } elseif {[regexp {^\{"icg": ("[^"]*"), "cell": ("[^"]*")\}$} $line \
+                   -> name cell]} {
+        lappend nd_icgs "$name: $cell"
+    } else {
+        fail $workdir "malformed NDJSON line: $line"
+    }
+}
+
+if {$json_icgs != {{"icg_0": "sky130_fd_sc_hd__dlclkp_1"}}} {
+    fail $workdir "unexpected JSON ICGs: $json_icgs"
+}
+if {$nd_icgs != $json_icgs} {
+    fail $workdir "NDJSON ICGs $nd_icgs differ from JSON $json_icgs"
+}
+if {$json_flops != [lsort $json_flops]} {
+    fail $workdir "gated registers are not sorted: $json_flops"
+}
+if {$nd_flops != $json_flops} {
+    fail $workdir \
+        "NDJSON gated registers $nd_flops differ from JSON $json_flops"
+}
+
+puts "ICG_JSON_TEST: PASS"
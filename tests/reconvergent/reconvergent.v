@@ -0,0 +1,42 @@
+// Three diamonds in a row: a two-buffer branch and a one-buffer branch
+// reconverge on an AND2 each time. y is timed through all of them, z only
+// through the first, so the two endpoints share a worst-path prefix.
+module reconvergent(
+    input a,
+    output y,
+    output z
+);
+  wire n0;
+  wire d0_l0;
+  wire d0_l1;
+  wire d0_s;
+  wire n1;
+  wire d1_l0;
+  wire d1_l1;
+  wire d1_s;
+  wire n2;
+  wire d2_l0;
+  wire d2_l1;
+  wire d2_s;
+  wire n3;
+
+  BUF_sp0_X1 root(.A(a), .Y(n0));
+
+  BUF_sp0_X1 d0_long_0(.A(n0), .Y(d0_l0));
+  BUF_sp0_X1 d0_long_1(.A(d0_l0), .Y(d0_l1));
+  BUF_sp0_X1 d0_short(.A(n0), .Y(d0_s));
+  AND2_sp0_X1 d0_join(.A(d0_l1), .B(d0_s), .Y(n1));
+
+  BUF_sp0_X1 d1_long_0(.A(n1), .Y(d1_l0));
+  BUF_sp0_X1 d1_long_1(.A(d1_l0), .Y(d1_l1));
+  BUF_sp0_X1 d1_short(.A(n1), .Y(d1_s));
+  AND2_sp0_X1 d1_join(.A(d1_l1), .B(d1_s), .Y(n2));
+
+  BUF_sp0_X1 d2_long_0(.A(n2), .Y(d2_l0));
+  BUF_sp0_X1 d2_long_1(.A(d2_l0), .Y(d2_l1));
+  BUF_sp0_X1 d2_short(.A(n2), .Y(d2_s));
+  AND2_sp0_X1 d2_join(.A(d2_l1), .B(d2_s), .Y(n3));
+
+  BUF_sp0_X1 tail_y(.A(n3), .Y(y));
+  BUF_sp0_X1 tail_z(.A(n1), .Y(z));
+endmodule
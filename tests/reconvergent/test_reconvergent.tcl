@@ -0,0 +1,55 @@
+# Graph scoring must credit every violating endpoint once per instance on its
+# worst path, capped at that endpoint's violation, exactly as path scoring
+# does, even where the paths fan out and reconverge.
+read_liberty reconvergent.lib
+read_verilog reconvergent.v
+link_design reconvergent
+
+# y violates by 3.7ns and z by 0.2ns; an upsize removes 0.4ns per stage
+create_clock -name test_clk -period 2.3
+set_input_delay 0.0 -clock test_clk [get_ports a]
+set_output_delay 0.0 -clock test_clk [get_ports {y z}]
+
+proc fail {message} {
+    puts "RECONVERGENT_TEST: FAIL ($message)"
+    exit 1
+}
+
+proc same_score {a b} {
+    return [expr {abs($a - $b) <= 1e-6 * max(abs($a), abs($b), 1e-12)}]
+}
+
+set path_scores [sta::offender_scores]
+set graph_scores [sta::offender_scores -graph_scoring]
+
+if {[lsort [dict keys $path_scores]] ne [lsort [dict keys $graph_scores]]} {
+    fail "scored instances differ: path [lsort [dict keys $path_scores]],\
+        graph [lsort [dict keys $graph_scores]]"
+}
+dict for {inst score} $path_scores {
+    if {![same_score $score [dict get $graph_scores $inst]]} {
+        fail "$inst scores $score on paths, [dict get $graph_scores $inst]\
+            on the graph"
+    }
+}
+
+# Shared by both endpoints: 0.4ns for y plus 0.2ns (z's whole violation)
+foreach inst {root d0_long_0 d0_long_1 d0_join} {
+    if {![same_score [dict get $graph_scores $inst] 0.6e-9]} {
+        fail "$inst scores [dict get $graph_scores $inst], expected 0.6ns"
+    }
+}
+# On y's path alone, counted once despite the reconvergence behind it
+foreach inst {d1_join d2_long_0 d2_join tail_y} {
+    if {![same_score [dict get $graph_scores $inst] 0.4e-9]} {
+        fail "$inst scores [dict get $graph_scores $inst], expected 0.4ns"
+    }
+}
+# Short branches are on no worst path
+foreach inst {d0_short d1_short d2_short} {
+    if {[dict exists $graph_scores $inst]} {
+        fail "$inst is off every worst path but scored"
+    }
+}
+
+puts "RECONVERGENT_TEST: PASS"
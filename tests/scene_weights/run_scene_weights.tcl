@@ -0,0 +1,31 @@
+# Size the scene_weights design for one batch under the scene weights in
+# SILISIZER_SCENE_WEIGHTS and print the instance that batch resized
+set workdir [file normalize $::env(SILISIZER_SCENE_DIR)]
+file delete -force $workdir
+file mkdir [file join $workdir data]
+
+define_corners slow fast
+read_liberty -corner slow slow.lib
+read_liberty -corner fast fast.lib
+read_verilog scene_weights.v
+link_design scene_weights
+
+# Each scene has one path violating by 1.5ns and one by 0.2ns
+create_clock -name test_clk -period 0.5
+set_input_delay 0.0 -clock test_clk [get_ports {a b}]
+set_output_delay 0.0 -clock test_clk [get_ports {y z}]
+
+if {[catch {sta::silisize -max_iters 1 \
+        -scene_weights $::env(SILISIZER_SCENE_WEIGHTS) $workdir} result] ||
+    $result != 0} {
+    puts "SCENE_RUN: FAIL (silisize: $result)"
+    file delete -force $workdir
+    exit 1
+}
+
+set transforms [open [file join $workdir data resized_cells.tsv] r]
+set lines [split [string trim [read $transforms]] "\n"]
+close $transforms
+file delete -force $workdir
+
+puts "FIRST_RESIZE: [lindex [split [lindex $lines 1] "\t"] 1]"
@@ -0,0 +1,11 @@
+// Two single-cell paths whose criticality swaps between the scenes: ua is
+// slow in the slow scene and ub in the fast one.
+module scene_weights(
+    input a,
+    input b,
+    output y,
+    output z
+);
+  BUFA_sp0_X1 ua(.A(a), .Y(y));
+  BUFB_sp0_X1 ub(.A(b), .Y(z));
+endmodule
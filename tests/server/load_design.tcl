@@ -0,0 +1,9 @@
+# Design served by the -server test: the wns_policy chain, loaded once
+set design_dir [file join [file dirname [info script]] .. wns_policy]
+read_liberty [file join $design_dir wns_policy.lib]
+read_verilog [file join $design_dir wns_policy.v]
+link_design wns_policy
+
+create_clock -name test_clk -period 1.0
+set_input_delay 0.0 -clock test_clk [get_ports {a b}]
+set_output_delay 0.0 -clock test_clk [get_ports {fixed_y opt_y}]
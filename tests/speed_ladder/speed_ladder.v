@@ -0,0 +1,13 @@
+module speed_ladder(
+    input a,
+    output y
+);
+  wire n0;
+  wire n1;
+  wire n2;
+
+  BUF_sp0_X1 buf_0(.A(a), .Y(n0));
+  BUF_sp0_X1 buf_1(.A(n0), .Y(n1));
+  BUF_sp0_X1 buf_2(.A(n1), .Y(n2));
+  BUF_sp0_X1 buf_3(.A(n2), .Y(y));
+endmodule
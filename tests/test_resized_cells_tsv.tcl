@@ -36,10 +36,40 @@ if {![file exists $tsv]} {
 set transforms [open $tsv r]
 set lines [split [string trim [read $transforms]] "\n"]
 close $transforms
-file delete -force $workdir
 
 if {[llength $lines] < 1 || [lindex $lines 0] ne "Scope\tInstance"} {
     puts "RESIZED_CELLS_TSV_TEST: FAIL (bad header: [lindex $lines 0])"
+    file delete -force $workdir
+    exit 1
+}
+
+# -gzip writes the same rows to resized_cells.tsv.gz
+if {[catch {sta::silisize -gzip $workdir} result] || $result != 0} {
+    puts "RESIZED_CELLS_TSV_TEST: FAIL (silisize -gzip error: $result)"
+    file delete -force $workdir
+    exit 1
+}
+set transforms [open [file join $workdir data resized_cells.tsv.gz] rb]
+set lines [split [string trim [zlib gunzip [read $transforms]]] "\n"]
+close $transforms
+
+# Each run leaves only its own format behind
+if {[file exists [file join $workdir data resized_cells.tsv]]} {
+    puts "RESIZED_CELLS_TSV_TEST: FAIL (-gzip left a stale resized_cells.tsv)"
+    file delete -force $workdir
+    exit 1
+}
+if {[catch {sta::silisize $workdir} result] || $result != 0 ||
+    [file exists [file join $workdir data resized_cells.tsv.gz]]} {
+    puts "RESIZED_CELLS_TSV_TEST: FAIL (a plain run left a stale\
+        resized_cells.tsv.gz)"
+    file delete -force $workdir
+    exit 1
+}
+file delete -force $workdir
+
+if {[llength $lines] < 1 || [lindex $lines 0] ne "Scope\tInstance"} {
+    puts "RESIZED_CELLS_TSV_TEST: FAIL (bad gzip header: [lindex $lines 0])"
     exit 1
 }
 
@@ -17,7 +17,22 @@ foreach command [list \
         [list sta::silisize $workdir] \
         [list sta::silisize -all $workdir] \
         [list sta::silisize -wns $workdir] \
-        [list sta::silisize -all -wns $workdir]] {
+        [list sta::silisize -all -wns $workdir] \
+        [list sta::silisize -incremental $workdir] \
+        [list sta::silisize -incremental -full_retime 2 $workdir] \
+        [list sta::silisize -resume $workdir] \
+        [list sta::silisize -gzip $workdir] \
+        [list sta::silisize -graph_scoring $workdir] \
+        [list sta::silisize -per_scene $workdir] \
+        [list sta::silisize -speculate 3 $workdir] \
+        [list sta::silisize -stream_paths -memory_budget 64 $workdir] \
+        [list sta::silisize -quiet $workdir] \
+        [list sta::silisize -batch_policy predictive $workdir] \
+        [list sta::silisize -disjoint $workdir] \
+        [list sta::silisize -shards 4 $workdir] \
+        [list sta::silisize -max_time 3600 -max_iters 2 $workdir] \
+        [list sta::silisize -verbose -incremental $workdir] \
+        [list sta::silisize -trace [file join $workdir trace.json] $workdir]] {
     if {[catch $command result]} {
         lappend failures "$command failed: $result"
     } elseif {$result != 0} {
@@ -27,10 +42,42 @@ foreach command [list \
 
 if {![catch {sta::silisize -unknown $workdir} result]} {
     lappend failures "sta::silisize accepted an unknown flag"
-} elseif {$result ne {unknown option "-unknown": must be -all or -wns}} {
+} elseif {$result ne {unknown option "-unknown": must be -all, -wns, -incremental, -full_retime, -resume, -gzip, -trace, -graph_scoring, -per_scene, -scene_weights, -speculate, -stream_paths, -memory_budget, -max_time, -max_iters, -batch_policy, -disjoint, -shards, -quiet or -verbose}} {
     lappend failures "sta::silisize returned a misleading error: $result"
 }
 
+if {![catch {sta::silisize -full_retime 0 $workdir} result]} {
+    lappend failures "sta::silisize accepted a zero -full_retime interval"
+}
+
+foreach output {data/silisize_metrics.json trace.json} {
+    if {![file exists [file join $workdir $output]]} {
+        lappend failures "sta::silisize did not write $output"
+    }
+}
+
+if {![catch {sta::silisize -memory_budget 0 $workdir} result]} {
+    lappend failures "sta::silisize accepted a zero -memory_budget"
+}
+
+if {![catch {sta::silisize -batch_policy halving $workdir} result]} {
+    lappend failures "sta::silisize accepted an unknown -batch_policy"
+}
+
+foreach flag {-max_time -max_iters -shards} {
+    if {![catch {sta::silisize $flag 0 $workdir} result]} {
+        lappend failures "sta::silisize accepted a zero $flag"
+    }
+}
+
+if {![catch {sta::silisize -scene_weights {no_such_scene 2.0} $workdir}]} {
+    lappend failures "sta::silisize accepted a weight for a missing scene"
+}
+
+if {![catch {sta::silisize -scene_weights {default} $workdir}]} {
+    lappend failures "sta::silisize accepted an odd -scene_weights list"
+}
+
 file delete -force $workdir
 
 if {[llength $failures]} {
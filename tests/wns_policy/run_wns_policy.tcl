@@ -0,0 +1,55 @@
+# Run the WNS policy on the wns_policy design with extra sta::silisize flags
+# and print the resize count, journaled batch count, whether
+# resized_cells.tsv is well formed and the final WNS, for tests that compare
+# runs:
+#   SILISIZER_POLICY_FLAGS  extra flags, e.g. "-graph_scoring"
+#   SILISIZER_POLICY_DIR    work directory (default ./work_run)
+set flags {}
+if {[info exists ::env(SILISIZER_POLICY_FLAGS)]} {
+    set flags $::env(SILISIZER_POLICY_FLAGS)
+}
+set workdir [file normalize work_run]
+if {[info exists ::env(SILISIZER_POLICY_DIR)]} {
+    set workdir [file normalize $::env(SILISIZER_POLICY_DIR)]
+}
+file delete -force $workdir
+file mkdir [file join $workdir data]
+
+read_liberty wns_policy.lib
+read_verilog wns_policy.v
+link_design wns_policy
+
+create_clock -name test_clk -period 1.0
+set_input_delay 0.0 -clock test_clk [get_ports {a b}]
+set_output_delay 0.0 -clock test_clk [get_ports {fixed_y opt_y}]
+
+if {[catch {sta::silisize -wns {*}$flags $workdir} result] || $result != 0} {
+    puts "POLICY_RUN: FAIL (silisize: $result)"
+    file delete -force $workdir
+    exit 1
+}
+
+set transforms [open [file join $workdir data resized_cells.tsv] r]
+set contents [read $transforms]
+close $transforms
+set lines [split [string trim $contents] "\n"]
+set journal [open [file join $workdir data silisize_journal.tsv] r]
+set batches [regexp -all -line {^end$} [read $journal]]
+close $journal
+file delete -force $workdir
+
+# A header, then one "module <TAB> cell" row per resize, each line complete
+set tsv_ok [expr {[string index $contents end] eq "\n" &&
+                  [lindex $lines 0] eq "Scope\tInstance"}]
+foreach line [lrange $lines 1 end] {
+    set fields [split $line "\t"]
+    if {[llength $fields] != 2 || [lindex $fields 0] eq "" ||
+        [lindex $fields 1] eq ""} {
+        set tsv_ok 0
+    }
+}
+
+puts "POLICY_RESIZES: [expr {[llength $lines] - 1}]"
+puts "POLICY_BATCHES: $batches"
+puts "POLICY_TSV: [expr {$tsv_ok ? "ok" : "malformed"}]"
+puts "POLICY_WNS: [worst_slack -max]"
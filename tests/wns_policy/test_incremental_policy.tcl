@@ -0,0 +1,38 @@
+# -incremental must converge to the same resizes as full re-timing
+set workdir [file normalize [file join [pwd] work_incremental]]
+file delete -force $workdir
+file mkdir [file join $workdir data]
+
+read_liberty wns_policy.lib
+read_verilog wns_policy.v
+link_design wns_policy
+
+create_clock -name test_clk -period 1.0
+set_input_delay 0.0 -clock test_clk [get_ports {a b}]
+set_output_delay 0.0 -clock test_clk [get_ports {fixed_y opt_y}]
+
+if {[catch {sta::silisize -incremental -wns $workdir} result]} {
+    puts "INCREMENTAL_POLICY_TEST: FAIL (silisize error: $result)"
+    file delete -force $workdir
+    exit 1
+}
+if {$result != 0} {
+    puts "INCREMENTAL_POLICY_TEST: FAIL (silisize returned $result)"
+    file delete -force $workdir
+    exit 1
+}
+
+set transforms [open [file join $workdir data resized_cells.tsv] r]
+set lines [split [string trim [read $transforms]] "\n"]
+close $transforms
+file delete -force $workdir
+
+# Only opt_y sits in the fanout of the resized buffers, so the fixed_y slack
+# (and with it the stalled WNS) is reused between passes. The batches must
+# match test_wns_policy.tcl: 1, 2, then 4 resizes.
+if {[llength $lines] != 8} {
+    puts "INCREMENTAL_POLICY_TEST: FAIL (expected 7 resizes, got [expr {[llength $lines] - 1}])"
+    exit 1
+}
+
+puts "INCREMENTAL_POLICY_TEST: PASS"
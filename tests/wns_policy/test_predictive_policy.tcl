@@ -0,0 +1,72 @@
+# -batch_policy predictive must start from a one-cell batch and then size
+# each batch from the TNS gained per swap. Forty identical one-buffer paths
+# each violate by 0.25ns and an upsize fixes one outright, so every swap
+# gains 0.25ns of TNS and WNS never moves until the last path is fixed.
+set workdir [file normalize [file join [pwd] work_predictive]]
+file delete -force $workdir
+file mkdir [file join $workdir data]
+
+set path_count 40
+set netlist [file join $workdir predictive.v]
+set stream [open $netlist w]
+set ports {}
+for {set i 0} {$i < $path_count} {incr i} {
+    lappend ports "input a$i" "output y$i"
+}
+puts $stream "module predictive([join $ports ", "]);"
+for {set i 0} {$i < $path_count} {incr i} {
+    puts $stream "  BUF_sp0_X1 path_$i (.A(a$i), .Y(y$i));"
+}
+puts $stream "endmodule"
+close $stream
+
+read_liberty wns_policy.lib
+read_verilog $netlist
+link_design predictive
+
+create_clock -name test_clk -period 0.25
+set_input_delay 0.0 -clock test_clk [all_inputs]
+set_output_delay 0.0 -clock test_clk [all_outputs]
+
+proc fail {message} {
+    global workdir
+    puts "PREDICTIVE_POLICY_TEST: FAIL ($message)"
+    file delete -force $workdir
+    exit 1
+}
+
+if {[catch {sta::silisize -batch_policy predictive $workdir} result] ||
+    $result != 0} {
+    fail "silisize: $result"
+}
+
+set journal [open [file join $workdir data silisize_journal.tsv] r]
+set sizes {}
+set next_sizes {}
+foreach line [split [read $journal] "\n"] {
+    set fields [split $line "\t"]
+    switch -- [lindex $fields 0] {
+        batch {
+            lappend next_sizes [lindex $fields 2]
+            set swaps 0
+        }
+        swap { incr swaps }
+        end { lappend sizes $swaps }
+    }
+}
+close $journal
+file delete -force $workdir
+
+# The first batch has no feedback: one cell, then twice that. From then on
+# the estimate is half the remaining TNS over 0.25ns per swap, clamped to
+# [current / 2, 8 * current]: 39 left asks for 19.5 but may only grow to 16,
+# 37 left asks for 18.5, 21 left asks for 10.5. The last batch takes the
+# three cells left.
+if {$sizes ne {1 2 16 18 3}} {
+    fail "batch sizes $sizes, expected 1 2 16 18 3"
+}
+if {[lrange $next_sizes 0 3] ne {2 16 18 10}} {
+    fail "next batch sizes [lrange $next_sizes 0 3], expected 2 16 18 10"
+}
+
+puts "PREDICTIVE_POLICY_TEST: PASS"
@@ -0,0 +1,64 @@
+# -resume must replay the journaled batches and continue from the saved state
+set workdir [file normalize [file join [pwd] work_resume]]
+file delete -force $workdir
+file mkdir [file join $workdir data]
+
+read_liberty wns_policy.lib
+read_verilog wns_policy.v
+link_design wns_policy
+
+create_clock -name test_clk -period 1.0
+set_input_delay 0.0 -clock test_clk [get_ports {a b}]
+set_output_delay 0.0 -clock test_clk [get_ports {fixed_y opt_y}]
+
+# A run killed while writing its second batch: the first batch is complete,
+# the second has no end marker and must be ignored. The journaled WNS is
+# tiny so the first resumed pass counts as a stall, as it would have.
+set journal [open [file join $workdir data silisize_journal.tsv] w]
+puts $journal "# silisize journal v1"
+puts $journal "batch\t0\t2\t0\t-1e-15"
+puts $journal "swap\twns_policy\topt_path_0"
+puts $journal "end"
+puts $journal "batch\t1\t4\t1\t-1e-15"
+puts $journal "swap\twns_policy\topt_path_9"
+close $journal
+
+if {[catch {sta::silisize -resume -wns $workdir} result]} {
+    puts "RESUME_POLICY_TEST: FAIL (silisize error: $result)"
+    file delete -force $workdir
+    exit 1
+}
+if {$result != 0} {
+    puts "RESUME_POLICY_TEST: FAIL (silisize returned $result)"
+    file delete -force $workdir
+    exit 1
+}
+
+set transforms [open [file join $workdir data resized_cells.tsv] r]
+set lines [split [string trim [read $transforms]] "\n"]
+close $transforms
+set journal [open [file join $workdir data silisize_journal.tsv] r]
+set batches [regexp -all -line {^end$} [read $journal]]
+close $journal
+file delete -force $workdir
+
+if {[get_property [get_cells opt_path_0] ref_name] ne "BUF_sp1_X1"} {
+    puts "RESUME_POLICY_TEST: FAIL (journaled opt_path_0 was not replayed)"
+    exit 1
+}
+if {[lindex $lines 1] ne "wns_policy\topt_path_0"} {
+    puts "RESUME_POLICY_TEST: FAIL (replayed resize missing from TSV)"
+    exit 1
+}
+# The replayed resize, then batches of 2 and 4 before the WNS stall stops
+# the run, exactly as in test_wns_policy.tcl.
+if {[llength $lines] != 8} {
+    puts "RESUME_POLICY_TEST: FAIL (expected 7 resizes, got [expr {[llength $lines] - 1}])"
+    exit 1
+}
+if {$batches != 3} {
+    puts "RESUME_POLICY_TEST: FAIL (expected 3 journaled batches, got $batches)"
+    exit 1
+}
+
+puts "RESUME_POLICY_TEST: PASS"